@@ -0,0 +1,93 @@
+#!/bin/bash
+#Runs the task1 distance sweep and the task2/task3 contention sweeps once per rate adaptation manager and
+#prints mean throughput and simulator CPU cost per manager. Results end up in taskN/benchmark.csv.
+#Then times the setup of single task2 runs with STARTUP stations (100, 1000 and 5000 by default, STARTUP=""
+#skips it), without and with batch rayleigh fading, and prints setup time and peak memory to startup.txt, so
+#setup or per-link state that grows faster than the deployment shows up.
+
+export MANAGERS="${MANAGERS:-Aarf,Cara,Minstrel,Ideal,Onoe,Amrr,Aarfcd,ConstantRate}"
+export CITARGET=0 #same seeds for every manager, so the CPU cost is comparable
+export PROFILE=true
+export FRESH=true #measure every run, do not serve any from the result index
+export RESULT=benchmark
+STARTUP="${STARTUP-100 1000 5000}"
+
+#awk function splitting a CSV line into out[1..n], quoted fields may hold commas
+CSVFIELDS='
+  function fields(line, out,    n, quoted, c, i, field) {
+    n = 0; field = ""; quoted = 0
+    for (i = 1; i <= length(line); ++i) {
+      c = substr(line, i, 1)
+      if (c == "\"") quoted = !quoted
+      else if (c == "," && !quoted) { out[++n] = field; field = "" }
+      else field = field c
+    }
+    out[++n] = field
+    return n
+  }'
+
+summarize ()
+{
+  #mean throughput, CPU seconds and scheduled events per second of every manager in a result file
+  awk "$CSVFIELDS"'
+    NR == 1 { n = fields($0, names); for (i = 1; i <= n; ++i) column[names[i]] = i; next }
+    {
+      fields($0, value)
+      manager = value[column["manager"]]
+      runs[manager]++
+      throughput[manager] += value[column["throughput"]]
+      cpu[manager] += value[column["cpuSeconds"]]
+      events[manager] += value[column["eventsPerSecond"]]
+      unit = value[column["throughputUnit"]]
+    }
+    END {
+      printf "%-14s %6s %16s %12s %12s %14s\n", "manager", "runs", "throughput(" unit ")", "cpu total s", "cpu/run s", "events/s"
+      for (manager in runs)
+        printf "%-14s %6d %16.3f %12.2f %12.3f %14.0f\n", manager, runs[manager], throughput[manager] / runs[manager],
+               cpu[manager], cpu[manager] / runs[manager], events[manager] / runs[manager]
+    }' "$1"
+}
+
+startup_table ()
+{
+  #setup seconds and peak memory of every run in a result file, one row per station count
+  awk "$CSVFIELDS"'
+    NR == 1 { n = fields($0, names); for (i = 1; i <= n; ++i) column[names[i]] = i; next }
+    NR == 2 { printf "%10s %10s %12s %14s %12s %12s %12s\n", "stations", "fading", "build s", "topology s", "stack s", "run s", "peak RSS MB" }
+    {
+      fields($0, value)
+      rss = value[column["peakRssKb"]]
+      printf "%10d %10s %12.3f %14.3f %12.3f %12.3f %12s\n", value[column["nodeNum"]] * value[column["apNum"]],
+             value[column["rayleigh"]] == 1 ? value[column["fading"]] : "none",
+             value[column["buildSeconds"]], value[column["topologySeconds"]], value[column["stackSeconds"]],
+             value[column["runSeconds"]], rss ~ /^-?nan$/ ? "n/a" : sprintf ("%.1f", rss / 1024)
+    }' "$1"
+}
+
+for TASK in 1 2 3
+do
+  echo "Benchmarking Task$TASK"
+  cd ./task$TASK
+  FILENAME="./result/benchmark-task$TASK.csv" ./script$TASK.sh
+  summarize benchmark.csv | tee benchmark.txt
+  cd ..
+done
+
+if [ -n "$STARTUP" ]
+then
+  echo "Benchmarking setup"
+  cp ./template.cc ../scratch/template.cc
+  SCENARIO="$(realpath ./task2/task2.ini)"
+  rm -f ./task2/startup.csv
+  for STATIONS in $STARTUP
+  do
+    for RAYLEIGH in false true
+    do
+      #the run stops just after the senders start, so nearly all of its time is the setup; one process per
+      #run, so the peak memory is that run's
+      (cd .. && ./waf --run "template --scenario=$SCENARIO --nodeNum=$STATIONS --rayleigh=$RAYLEIGH --fading=batch --stopTime=1.1 --verbose=false --details=false --file=assignment1/task2/startup.csv")
+    done
+  done
+  startup_table ./task2/startup.csv | tee startup.txt
+fi
+echo "BENCHMARK DONE"
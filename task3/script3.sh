@@ -1,29 +1,60 @@
 #!/bin/bash
-cp ./template.cc ../../scratch/template.cc
-FILENAME="./result/task3.txt"
+cp ../template.cc ../../scratch/template.cc #one program for all tasks, taskN.ini makes it this task
+FILENAME="${FILENAME:-./result/task3.csv}"
+RESULT="${RESULT:-result}" #copied back as $RESULT.csv next to this script
+FORMAT="csv" #csv or bin, one self-describing record per run
 ASSIGNMENTDIREC="assignment1/task3/"
+SCENARIO="$(realpath "${SCENARIO:-task3.ini}")" #the study itself: topology, channel, managers, traffic and sweep grid
+BUILDID="$(sha1sum ../template.cc | cut -c1-16)" #runs in the result index only count for this very program, see ResultIndex
 
 VERBOSE="false"
+PROFILE="${PROFILE:-false}" #true counts scheduled events per type into the .events file and per second into the records
+WORKERS="$(nproc)" #parallel worker processes, 0 runs every point inside the waf process
+#Any of these set in the environment overrides the scenario file, e.g. CITARGET=0.02 MANAGERS=Aarf,Minstrel ./script3.sh
+#MANAGERS FADING COHERENCETIME TRAFFIC LOAD MOBILITY SPEED MEASURE NODENUMS CITARGET MAXSEEDS PAIRED REPLICATION WARMUP APNUM CHANNELS SAMPLEINTERVAL FRAMETRACE
+OVERRIDES=""
+override ()
+{
+  if [ -n "${!2}" ]
+  then
+    OVERRIDES="$OVERRIDES --$1=${!2}"
+  fi
+}
+override managers MANAGERS
+override fading FADING
+override coherenceTime COHERENCETIME
+override traffic TRAFFIC
+override load LOAD
+override mobility MOBILITY
+override speed SPEED
+override measure MEASURE
+override nodeNums NODENUMS
+override ciTarget CITARGET
+override maxSeeds MAXSEEDS
+override paired PAIRED
+override replication REPLICATION
+override warmup WARMUP
+override apNum APNUM
+override channels CHANNELS
+override sampleInterval SAMPLEINTERVAL
+override frameTrace FRAMETRACE #true writes a binary frame trace per run next to FILENAME, read it with traceanalyzer.cc
 cd ../../
-rm $FILENAME
-for RAYLEIGH in true #Only fading is used
-do
-	for CARA in false true #false true
-	do
-		echo -e "\nRAYLEIGH: $RAYLEIGH, CARA: $CARA" >> $FILENAME
-		for nodeNum in {0..9} #0..9
-
-		do
-		 for seed in {1..5} #1..5
-		 do
-			 echo "Number of Stations: $[nodeNum*5+1], Seed:$seed"
-			 ./waf --run "template --verbose=$VERBOSE --seed=$seed --file=$FILENAME --nodeNum=$[nodeNum*5+1] --cara=$CARA --rayleigh=$RAYLEIGH"
-
-		 done
-		done
-	done
-done
-echo -e "\n" >> $FILENAME
-cp $FILENAME "$ASSIGNMENTDIREC./result.txt"
+CIFILE="${FILENAME%.csv}.ci.csv" #per point mean throughput and confidence interval
+SUMMARYFILE="${FILENAME%.csv}.summary.csv" #per point mean/sd/min/max/CI of the main metrics, kept current while the sweep runs
+PLOTFILE="${FILENAME%.csv}.plot.csv" #one row per x value, mean throughput and CI of every series as columns
+PAIREDFILE="${FILENAME%.csv}.paired.csv" #per manager and point, throughput difference to the first manager with its paired and unpaired CI
+INDEXFILE="${FILENAME%.csv}.index.csv" #finished runs by build, a rerun of the same template.cc only runs what is missing from it
+if [ "$FRESH" = "true" ] #FRESH=true starts over instead of resuming
+then
+  rm -f $FILENAME ${FILENAME%.csv}.*.csv #also the index and the detail files
+fi
+rm -f $CIFILE $SUMMARYFILE $PLOTFILE $PAIREDFILE
+#The whole grid runs from one waf launch, see RunSweep/RunJobs in ../template.cc
+./waf --run "template --scenario=$SCENARIO --verbose=$VERBOSE --profile=$PROFILE --file=$FILENAME --format=$FORMAT --sweep=true --workers=$WORKERS --buildId=$BUILDID$OVERRIDES"
+cp $FILENAME "$ASSIGNMENTDIREC./$RESULT.csv"
+cp $CIFILE "$ASSIGNMENTDIREC./$RESULT.ci.csv" 2>/dev/null
+cp $SUMMARYFILE "$ASSIGNMENTDIREC./$RESULT.summary.csv"
+cp $PLOTFILE "$ASSIGNMENTDIREC./$RESULT.plot.csv"
+cp $PAIREDFILE "$ASSIGNMENTDIREC./$RESULT.paired.csv" 2>/dev/null
 cd $ASSIGNMENTDIREC
 echo ALLDONE
@@ -0,0 +1,4497 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <iostream>
+#include <fstream>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/random-variable-stream.h"
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <limits>
+#include <cmath>
+#include <map>
+#include <set>
+#include <typeinfo>
+#include <cxxabi.h>
+
+using namespace ns3;
+NS_LOG_COMPONENT_DEFINE ("AssignmentTemplate");
+
+//Parameters of a single simulation run, one point of a sweep
+struct ScenarioParams
+{
+  bool rayleigh;
+  bool cara; //the manager is CaraWifiManager, kept next to manager for the existing analyses
+  int seed;
+  double distance;
+  int nodeNum;
+  double sampleInterval; //seconds between time-series samples, 0 turns the sampler off
+  int sampleCapacity; //samples the ring holds, 0 sizes it for the whole run
+  bool verbose; //print the per-station counter summary of every run
+  int apNum; //number of BSSs, each with its own AP and nodeNum stations
+  std::string apLayout; //"grid" or "hex" placement of the APs
+  double apSpacing; //metres between neighbouring APs
+  std::string channels; //channel numbers handed to the BSSs in turn, e.g. "1,6,11"
+  double warmup; //sweep: seconds of association run once per point before forking per seed, 0 builds every seed from scratch
+  bool lossCache; //remember the log-distance loss per node pair instead of computing it for every frame
+  std::string fading; //fading model of the rayleigh case: "nakagami", "batch", "block" or "ar1"
+  double coherenceTime; //seconds the gain of a link is held ("block") or its correlation time ("ar1")
+  std::string manager; //rate adaptation, a WifiRemoteStationManager name like "Minstrel" or "ns3::MinstrelWifiManager"
+  std::string managerAttributes; //attributes of the manager as "Name=Value,Name=Value", at most 8
+  std::string traffic; //"cbr", "bursty" (on-off periods), "mixed" (IMIX size per packet) or "bulk" (TCP BulkSend)
+  std::string dataRate; //rate of every sender while it is on, unless load is given
+  int packetSize; //application payload bytes, except for the drawn sizes of mixed
+  std::string load; //per-station offered load in Mbit/s as a random variable string, empty sends at dataRate
+  std::string onTime; //bursty: random variable of the on periods in seconds
+  std::string offTime; //bursty: random variable of the off periods in seconds
+  std::string measure; //"sink" counts bytes per station at the packet sinks, "flowmon" runs the full FlowMonitor
+  std::string mobility; //stations "static", "walk" (random walk), "waypoint" (random waypoint) or "away" from their AP
+  double speed; //m/s of moving stations
+  double mobilityBounds; //half width in metres of the square around its AP that walk and waypoint stations stay in
+  std::string replication; //"run": seed is the run number under the fixed rngSeed, "seed": seed is the ns-3 seed
+  int rngSeed; //ns-3 seed shared by all replications of replication "run"
+  double stopTime; //seconds simulated per run, the senders stop at the same time
+  std::string ssid; //SSID of the BSS, with "-k" appended for BSS k when there are several
+  std::string addressBase; //network of the /24 the APs and stations are numbered from
+  int port; //port of every measured flow, the TCP acknowledgements of bulk flow the other way
+  double lossExponent; //path loss exponent of the log-distance loss
+  std::string placement; //"disc": stations at stationRho around their AP, "distance": distance metres east of it (task1)
+  std::string stationRho; //random variable of the distance of a station to its AP for placement "disc" (task2 and task3)
+  std::string direction; //"random": every station draws whether it sends or receives, "uplink" or "downlink" for all
+  std::string throughputUnit; //"Mbps" over all but the first second of the run, or "Kib/s" over the whole run (task1)
+  std::string attributes; //ns3:: attribute defaults given on the command line or in the scenario file
+  std::string frameTrace; //file name the per-frame trace files of the runs are derived from, empty writes none
+};
+
+//Throughput of a flow in the unit of params.throughputUnit: Mbps over all but the first second of a run of
+//stopTime seconds (the 9 s the on-off applications are sending in the default 10 s run), or Kib/s over the whole run
+double
+ThroughputOf (uint64_t rxBytes, const ScenarioParams &params)
+{
+  if (params.throughputUnit == "Kib/s")
+    {
+      return rxBytes * 8.0 / (params.stopTime * 1024); //bits per byte/run time over bits per Kib
+    }
+  return rxBytes * 8.0/(params.stopTime - 1.0)/1000/1000;
+}
+
+//Parse a sweep range given either as "first:last[:step]" or as a comma separated list "a,b,c"
+std::vector<double>
+ParseRange (std::string spec)
+{
+  std::vector<double> values;
+  if (spec.find (':') != std::string::npos)
+    {
+      std::replace (spec.begin (), spec.end (), ':', ' ');
+      std::istringstream iss (spec);
+      double first = 0.0, last = 0.0, step = 1.0;
+      iss >> first >> last;
+      if (!(iss >> step) || step <= 0.0)
+        {
+          step = 1.0;
+        }
+      for (double v = first; v <= last + step * 1e-9; v += step)
+        {
+          values.push_back (v);
+        }
+      return values;
+    }
+  std::replace (spec.begin (), spec.end (), ',', ' ');
+  std::istringstream iss (spec);
+  std::string token;
+  while (iss >> token)
+    {
+      if (token == "true")
+        {
+          values.push_back (1.0);
+        }
+      else if (token == "false")
+        {
+          values.push_back (0.0);
+        }
+      else
+        {
+          values.push_back (atof (token.c_str ()));
+        }
+    }
+  return values;
+}
+
+//Split a list like "Aarf,Cara" at separator, dropping empty entries
+std::vector<std::string>
+SplitList (const std::string &spec, char separator)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (spec);
+  std::string item;
+  while (std::getline (iss, item, separator))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+//Random stream layout of a run. Every random variable gets its stream explicitly, so no draw depends on the
+//order things were created in or on how many other nodes there are: channel-wide models (fading) use the
+//streams below channelStreams, and every node owns streamsPerNode streams from NodeStream (node, purpose) on.
+const int64_t channelStreams = 1000;
+const int64_t streamsPerNode = 64;
+enum StreamPurpose
+{
+  STREAM_DEVICE = 0, //the wifi device: phy, mac and station manager
+  STREAM_STACK = 16, //the internet stack
+  STREAM_PLACEMENT = 32, //the initial position of a station
+  STREAM_MOBILITY = 36, //the mobility model and its waypoints
+  STREAM_TRAFFIC = 48 //the traffic of a station, see TrafficDraw
+};
+//The traffic draws of a station, offsets into its STREAM_TRAFFIC streams
+enum TrafficDraw
+{
+  TRAFFIC_DIRECTION,
+  TRAFFIC_START,
+  TRAFFIC_LOAD,
+  TRAFFIC_SIZE,
+  TRAFFIC_APPLICATION //on-off periods of its sender, two streams
+};
+
+int64_t
+NodeStream (uint32_t node, StreamPurpose purpose)
+{
+  return channelStreams + (int64_t)node * streamsPerNode + purpose;
+}
+
+//One uniform draw from the given traffic stream of a station
+double
+StationDraw (uint32_t node, TrafficDraw draw, double min, double max)
+{
+  Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+  variable->SetStream (NodeStream (node, STREAM_TRAFFIC) + draw);
+  return variable->GetValue (min, max);
+}
+
+//Seed and run of a replication. With "run" all replications share rngSeed and differ in the run number, as
+//ns-3 recommends, so the streams of two replications, or of two managers in the same one, never overlap.
+void
+SetRandomRun (const ScenarioParams &params)
+{
+  if (params.replication == "run")
+    {
+      SeedManager::SetSeed (params.rngSeed);
+      SeedManager::SetRun (params.seed);
+    }
+  else
+    {
+      SeedManager::SetSeed (params.seed);
+      SeedManager::SetRun (1);
+    }
+}
+
+//Socket factory of the senders and sinks of the traffic profile
+std::string
+TrafficSocketFactory (const ScenarioParams &params)
+{
+  return params.traffic == "bulk" ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory";
+}
+
+//Draw the offered load in bit/s of each station from its own traffic stream. Every sender gets packetSize
+//bytes per packet, except mixed ones, which draw the size of every packet (see ImixSizes).
+void
+DrawTraffic (const ScenarioParams &params, NodeContainer stations, std::vector<double> &rate, std::vector<uint32_t> &size)
+{
+  rate.assign (stations.GetN (), DataRate (params.dataRate).GetBitRate ());
+  size.assign (stations.GetN (), params.packetSize);
+  ObjectFactory factory;
+  std::istringstream iss (params.load);
+  if (!params.load.empty () && !(iss >> factory))
+    {
+      NS_FATAL_ERROR ("cannot parse load " << params.load);
+    }
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      uint32_t node = stations.Get (i)->GetId ();
+      if (!params.load.empty ())
+        {
+          Ptr<RandomVariableStream> load = factory.Create<RandomVariableStream> ();
+          load->SetStream (NodeStream (node, STREAM_TRAFFIC) + TRAFFIC_LOAD);
+          rate[i] = std::max (load->GetValue (), 0.001) * 1e6; //an on-off sender needs a positive rate
+        }
+    }
+}
+
+//Packet sizes of the sender of a mixed station: IMIX, 7:4:1 of 64, 576 and 1500 byte IP packets given as
+//UDP payload, drawn for every packet from the TRAFFIC_SIZE stream of the station. The on-off sender fires
+//its Tx trace before it schedules the next packet from its PacketSize, so the size set there goes into the
+//next packet and also spaces it from this one, which keeps the offered load of the station.
+class ImixSizes : public SimpleRefCount<ImixSizes>
+{
+public:
+  ImixSizes (Ptr<Application> app, uint32_t node)
+    : m_app (PeekPointer (app)),
+      m_size (CreateObject<UniformRandomVariable> ())
+  {
+    m_size->SetStream (NodeStream (node, STREAM_TRAFFIC) + TRAFFIC_SIZE);
+  }
+
+  //Draw the size of the next packet of the sender
+  void Next (void)
+  {
+    double u = m_size->GetValue (0.0, 12.0);
+    m_app->SetAttribute ("PacketSize", UintegerValue (u < 7.0 ? 36 : (u < 11.0 ? 548 : 1472)));
+  }
+
+private:
+  Application *m_app; //not a Ptr, the sender holds this through its Tx trace
+  Ptr<UniformRandomVariable> m_size;
+};
+
+void
+OnMixedTx (Ptr<ImixSizes> sizes, Ptr<const Packet> packet)
+{
+  sizes->Next ();
+}
+
+//Create one sender of the traffic profile on every node with a single helper Install. Remote, rate,
+//packet size and start time differ per station and are set afterwards by ConfigureSender.
+ApplicationContainer
+InstallSenders (const ScenarioParams &params, NodeContainer nodes)
+{
+  if (params.traffic == "bulk")
+    {
+      BulkSendHelper bulk (TrafficSocketFactory (params), Address ());
+      bulk.SetAttribute ("MaxBytes", UintegerValue (0)); //send until stopped
+      return bulk.Install (nodes);
+    }
+  OnOffHelper onoff (TrafficSocketFactory (params), Address ()); //create a new on-off application to send data
+  onoff.SetConstantRate (DataRate (params.dataRate), (uint32_t)params.packetSize); //CBR unless bursty
+  if (params.traffic == "bursty")
+    {
+      onoff.SetAttribute ("OnTime", StringValue (params.onTime));
+      onoff.SetAttribute ("OffTime", StringValue (params.offTime));
+    }
+  return onoff.Install (nodes);
+}
+
+//Point the sender of station node at remote and give it its own offered load (bit/s), packet size (drawn
+//per packet for mixed), start time and on-off period streams
+void
+ConfigureSender (Ptr<Application> app, const ScenarioParams &params, uint32_t node, const Address &remote,
+                 double rate, uint32_t size, double start)
+{
+  app->SetAttribute ("Remote", AddressValue (remote));
+  Ptr<OnOffApplication> onoff = DynamicCast<OnOffApplication> (app);
+  if (onoff != 0)
+    {
+      onoff->AssignStreams (NodeStream (node, STREAM_TRAFFIC) + TRAFFIC_APPLICATION);
+    }
+  if (params.traffic == "bulk")
+    {
+      app->SetAttribute ("SendSize", UintegerValue (size));
+    }
+  else
+    {
+      app->SetAttribute ("DataRate", DataRateValue (DataRate (static_cast<uint64_t> (rate))));
+      app->SetAttribute ("PacketSize", UintegerValue (size));
+    }
+  if (params.traffic == "mixed")
+    {
+      Ptr<ImixSizes> sizes = Create<ImixSizes> (app, node);
+      sizes->Next (); //the first packet
+      app->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&OnMixedTx, sizes));
+    }
+  app->SetStartTime (Seconds (start));
+}
+
+//Set the mobility model of the stations of the AP at ap on mobility, before it installs them. The models
+//are the stock ns-3 ones, which only work out a position when it is asked for: a walking station costs one
+//event per second, a waypoint station one per leg and one moving away from its AP none at all.
+void
+SetStationMobility (MobilityHelper &mobility, const ScenarioParams &params, Vector ap)
+{
+  std::ostringstream speed;
+  speed << "ns3::ConstantRandomVariable[Constant=" << params.speed << "]";
+  double bound = std::max (params.mobilityBounds, params.distance); //the distance study's station starts inside
+  if (params.mobility == "walk")
+    {
+      mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+                                 "Mode", StringValue ("Time"),
+                                 "Time", StringValue ("1s"), //new direction every second
+                                 "Speed", StringValue (speed.str ()),
+                                 "Bounds", RectangleValue (Rectangle (ap.x - bound, ap.x + bound, ap.y - bound, ap.y + bound)));
+    }
+  else if (params.mobility == "waypoint")
+    {
+      std::ostringstream x, y;
+      x << "ns3::UniformRandomVariable[Min=" << ap.x - bound << "|Max=" << ap.x + bound << "]";
+      y << "ns3::UniformRandomVariable[Min=" << ap.y - bound << "|Max=" << ap.y + bound << "]";
+      Ptr<RandomRectanglePositionAllocator> waypoints = CreateObject<RandomRectanglePositionAllocator> ();
+      waypoints->SetAttribute ("X", StringValue (x.str ()));
+      waypoints->SetAttribute ("Y", StringValue (y.str ()));
+      mobility.SetMobilityModel ("ns3::RandomWaypointMobilityModel",
+                                 "Speed", StringValue (speed.str ()),
+                                 "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+                                 "PositionAllocator", PointerValue (waypoints));
+    }
+  else if (params.mobility == "away")
+    {
+      mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+    }
+  else
+    {
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    }
+}
+
+//Start a station installed with SetStationMobility moving: with "away" it heads straight away from its AP
+//at ap, along x if it sits right on top of it
+void
+StartStationMobility (const ScenarioParams &params, Ptr<Node> station, Vector ap)
+{
+  if (params.mobility != "away")
+    {
+      return;
+    }
+  Ptr<ConstantVelocityMobilityModel> model = station->GetObject<ConstantVelocityMobilityModel> ();
+  Vector position = model->GetPosition ();
+  double dx = position.x - ap.x;
+  double dy = position.y - ap.y;
+  double length = std::sqrt (dx * dx + dy * dy);
+  if (length == 0.0)
+    {
+      dx = 1.0;
+      length = 1.0;
+    }
+  model->SetVelocity (Vector (dx / length * params.speed, dy / length * params.speed, 0.0));
+}
+
+void
+WriteAll (int fd, const std::string &data)
+{
+  size_t written = 0;
+  while (written < data.size ())
+    {
+      ssize_t n = write (fd, data.data () + written, data.size () - written);
+      if (n < 0 && errno == EINTR)
+        {
+          continue;
+        }
+      if (n <= 0)
+        {
+          break;
+        }
+      written += n;
+    }
+}
+
+double
+WallSeconds (void)
+{
+  struct timeval now;
+  gettimeofday (&now, 0);
+  return now.tv_sec + now.tv_usec * 1e-6;
+}
+
+//User plus system CPU time of this process in seconds
+double
+CpuSeconds (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+//Start a new peak memory measurement by resetting the resident set high-water mark of this process to
+//its current size (Linux clear_refs, since 4.0). getrusage only knows the peak over the whole process
+//lifetime, which for runs in the same process is the largest run so far. Returns false if unsupported.
+bool
+ResetPeakRss (void)
+{
+  int fd = open ("/proc/self/clear_refs", O_WRONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  bool reset = write (fd, "5", 1) == 1;
+  close (fd);
+  return reset;
+}
+
+//Peak resident set size in kilobytes since the last ResetPeakRss, -1 if it cannot be read
+long
+PeakRssKb (void)
+{
+  std::ifstream status ("/proc/self/status");
+  std::string line;
+  while (std::getline (status, line))
+    {
+      if (line.compare (0, 6, "VmHWM:") == 0)
+        {
+          return atol (line.c_str () + 6);
+        }
+    }
+  return -1;
+}
+
+//One self-describing result record: named columns in output order, each either numeric or text
+struct ResultRecord
+{
+  std::vector<std::string> names;
+  std::vector<double> numbers;
+  std::vector<std::string> texts;
+  std::vector<bool> isText;
+
+  void Add (const std::string &name, double value)
+  {
+    names.push_back (name);
+    numbers.push_back (value);
+    texts.push_back ("");
+    isText.push_back (false);
+  }
+  void AddText (const std::string &name, const std::string &value)
+  {
+    names.push_back (name);
+    numbers.push_back (0.0);
+    texts.push_back (value);
+    isText.push_back (true);
+  }
+  void Append (const ResultRecord &other)
+  {
+    names.insert (names.end (), other.names.begin (), other.names.end ());
+    numbers.insert (numbers.end (), other.numbers.begin (), other.numbers.end ());
+    texts.insert (texts.end (), other.texts.begin (), other.texts.end ());
+    isText.insert (isText.end (), other.isText.begin (), other.isText.end ());
+  }
+};
+
+//Detail records a run produces besides its result record, each kind goes to its own side file
+enum DetailKind
+{
+  DETAIL_FLOWS,
+  DETAIL_SAMPLES,
+  DETAIL_STATIONS,
+  DETAIL_BSS,
+  DETAIL_EVENTS,
+  DETAIL_KINDS
+};
+const char *detailNames[DETAIL_KINDS] = { "flows", "samples", "stations", "bss", "events" };
+
+//Side file of a detail kind: "result.csv" becomes "result.flows.csv"
+std::string
+DetailFileName (const std::string &fileName, const std::string &kind)
+{
+  std::string::size_type dot = fileName.rfind ('.');
+  std::string::size_type slash = fileName.rfind ('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+      return fileName + "." + kind;
+    }
+  return fileName.substr (0, dot) + "." + kind + fileName.substr (dot);
+}
+
+//Records encoded by a ResultWriter, ready to be appended to its file in one go
+struct EncodedRecords
+{
+  std::string header;
+  std::string data;
+};
+
+//Appends result records to a file, either as CSV with a header line or in a compact binary layout
+//("WRATEBIN1" line, a name:type schema line, then length-prefixed records of native doubles and
+//length-prefixed strings). Each batch goes out in a single write() under an exclusive flock(), so
+//concurrent runs appending to the same file never interleave. A file whose header does not match the
+//current column layout is moved aside to <file>.1, .2, ... instead of being silently extended.
+class ResultWriter
+{
+public:
+  ResultWriter (const std::string &fileName, bool binary)
+    : m_fileName (fileName),
+      m_binary (binary)
+  {
+  }
+
+  void Write (const ResultRecord &record) const
+  {
+    EncodedRecords encoded;
+    Encode (record, encoded);
+    Append (encoded);
+  }
+
+  void Encode (const ResultRecord &record, EncodedRecords &encoded) const
+  {
+    encoded.header = Header (record);
+    encoded.data += EncodeRecord (record);
+  }
+
+  //Replace the whole file with the encoded records through a rename, so readers never see a half-written table
+  void Replace (const EncodedRecords &encoded) const
+  {
+    std::string temporary = m_fileName + ".tmp";
+    int fd = open (temporary.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      {
+        NS_FATAL_ERROR ("Cannot open " << temporary << ": " << strerror (errno));
+      }
+    WriteAll (fd, encoded.header + encoded.data);
+    close (fd);
+    if (rename (temporary.c_str (), m_fileName.c_str ()) != 0)
+      {
+        NS_FATAL_ERROR ("Cannot replace " << m_fileName << ": " << strerror (errno));
+      }
+  }
+
+  void Append (const EncodedRecords &encoded) const
+  {
+    if (encoded.data.empty ())
+      {
+        return;
+      }
+    const std::string &header = encoded.header;
+    std::string data = encoded.data;
+    int fd = open (m_fileName.c_str (), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+      {
+        NS_FATAL_ERROR ("Cannot open " << m_fileName << ": " << strerror (errno));
+      }
+    flock (fd, LOCK_EX);
+    struct stat st;
+    fstat (fd, &st);
+    if (st.st_size == 0)
+      {
+        data = header + data;
+      }
+    else
+      {
+        std::string existing (header.size (), '\0');
+        if (pread (fd, &existing[0], header.size (), 0) != (ssize_t)header.size () || existing != header)
+          {
+            std::string aside = MoveAside ();
+            flock (fd, LOCK_UN);
+            close (fd);
+            std::cout << m_fileName << " holds records with a different column layout, moved to " << aside << std::endl;
+            Append (encoded);
+            return;
+          }
+      }
+    WriteAll (fd, data);
+    flock (fd, LOCK_UN);
+    close (fd);
+  }
+
+  //Remove the records of runs about to be run again, so their new records replace the old ones instead of
+  //being counted next to them. Every key holds the leading columns of the records of one run, all keys the
+  //same columns. A file with a different column layout is left alone, Append moves it aside. The file is
+  //read in chunks and every kept record moved down over the dropped ones in place, so memory stays at a
+  //chunk and a record however large the file; callers still pay a pass over it, see DropRuns.
+  void Drop (const std::vector<ResultRecord> &keys) const
+  {
+    if (keys.empty ())
+      {
+        return;
+      }
+    std::set<std::string> dropped;
+    for (size_t i = 0; i < keys.size (); ++i)
+      {
+        std::string key = EncodeRecord (keys[i]);
+        dropped.insert (m_binary ? key.substr (sizeof (uint32_t)) : key.substr (0, key.size () - 1));
+      }
+    int fd = open (m_fileName.c_str (), O_RDWR);
+    if (fd < 0)
+      {
+        return; //nothing written yet
+      }
+    flock (fd, LOCK_EX);
+    std::vector<bool> isText;
+    size_t start = ParseHeader (ReadHead (fd), isText);
+    if (start == std::string::npos)
+      {
+        flock (fd, LOCK_UN);
+        close (fd);
+        return;
+      }
+    std::string pending; //read but not yet handled, from file offset base on
+    off_t base = start;
+    off_t kept = start; //end of the records kept so far
+    size_t removed = 0;
+    bool eof = false;
+    while (!eof)
+      {
+        char buffer[65536];
+        ssize_t n = pread (fd, buffer, sizeof (buffer), base + pending.size ());
+        if (n < 0 && errno == EINTR)
+          {
+            continue;
+          }
+        eof = n <= 0;
+        pending.append (buffer, n > 0 ? n : 0);
+        size_t offset = 0;
+        while (offset < pending.size ())
+          {
+            size_t end = RecordEnd (pending, offset);
+            if (end == std::string::npos && !eof)
+              {
+                break; //the rest of the record is in the next chunk
+              }
+            end = std::min (end, pending.size ()); //a record cut off by a crash is kept as it is
+            if (dropped.count (RecordKey (pending.substr (offset, end - offset), isText, keys[0].names.size ())) > 0)
+              {
+                ++removed;
+              }
+            else
+              {
+                if (removed > 0) //behind what was read, so nothing unread is overwritten
+                  {
+                    lseek (fd, kept, SEEK_SET);
+                    WriteAll (fd, pending.substr (offset, end - offset));
+                  }
+                kept += end - offset;
+              }
+            offset = end;
+          }
+        pending.erase (0, offset);
+        base += offset;
+      }
+    if (removed > 0 && ftruncate (fd, kept) != 0)
+      {
+        NS_FATAL_ERROR ("Cannot rewrite " << m_fileName << ": " << strerror (errno));
+      }
+    flock (fd, LOCK_UN);
+    close (fd);
+  }
+
+private:
+  //Rename the file to the first free <file>.n, returning that name
+  std::string MoveAside (void) const
+  {
+    for (int n = 1; ; ++n)
+      {
+        std::ostringstream aside;
+        aside << m_fileName << "." << n;
+        struct stat st;
+        if (stat (aside.str ().c_str (), &st) != 0 && errno == ENOENT)
+          {
+            if (rename (m_fileName.c_str (), aside.str ().c_str ()) != 0)
+              {
+                NS_FATAL_ERROR ("Cannot move " << m_fileName << " aside: " << strerror (errno));
+              }
+            return aside.str ();
+          }
+      }
+  }
+
+  //The first 64 KiB of the file, which hold its header
+  static std::string ReadHead (int fd)
+  {
+    std::string head (65536, '\0');
+    ssize_t n;
+    while ((n = pread (fd, &head[0], head.size (), 0)) < 0 && errno == EINTR)
+      {
+      }
+    head.resize (n > 0 ? n : 0);
+    return head;
+  }
+
+  //Offset of the first record after the header at the start of contents, with the column types of a
+  //binary file, npos if contents starts with no header of this writer's format (nothing is then dropped)
+  size_t ParseHeader (const std::string &contents, std::vector<bool> &isText) const
+  {
+    size_t line = contents.find ('\n');
+    if (!m_binary)
+      {
+        return line == std::string::npos ? std::string::npos : line + 1;
+      }
+    if (contents.compare (0, 10, "WRATEBIN1\n") != 0)
+      {
+        return std::string::npos;
+      }
+    size_t schemaEnd = contents.find ('\n', 10);
+    if (schemaEnd == std::string::npos)
+      {
+        return std::string::npos;
+      }
+    std::vector<std::string> columns = SplitList (contents.substr (10, schemaEnd - 10), ',');
+    for (size_t i = 0; i < columns.size (); ++i)
+      {
+        isText.push_back (columns[i].size () >= 2 && columns[i].compare (columns[i].size () - 2, 2, ":s") == 0);
+      }
+    return schemaEnd + 1;
+  }
+
+  //End of the record starting at offset: the next line break outside quotes, or the length prefix; npos if
+  //the record goes on past the end of contents
+  size_t RecordEnd (const std::string &contents, size_t offset) const
+  {
+    if (m_binary)
+      {
+        uint32_t length = 0;
+        if (offset + sizeof (length) > contents.size ())
+          {
+            return std::string::npos;
+          }
+        memcpy (&length, contents.data () + offset, sizeof (length));
+        return offset + sizeof (length) + length <= contents.size () ? offset + sizeof (length) + length : std::string::npos;
+      }
+    bool quoted = false;
+    for (size_t i = offset; i < contents.size (); ++i)
+      {
+        if (contents[i] == '"')
+          {
+            quoted = !quoted;
+          }
+        else if (contents[i] == '\n' && !quoted)
+          {
+            return i + 1;
+          }
+      }
+    return std::string::npos;
+  }
+
+  //The first columns fields of an encoded record, as EncodeRecord writes a record of only those
+  std::string RecordKey (const std::string &record, const std::vector<bool> &isText, size_t columns) const
+  {
+    if (m_binary)
+      {
+        size_t offset = sizeof (uint32_t);
+        for (size_t i = 0; i < columns && i < isText.size () && offset <= record.size (); ++i)
+          {
+            uint16_t length = sizeof (double);
+            if (isText[i] && offset + sizeof (length) <= record.size ())
+              {
+                memcpy (&length, record.data () + offset, sizeof (length));
+                length += sizeof (length);
+              }
+            offset += length;
+          }
+        return offset <= record.size () ? record.substr (sizeof (uint32_t), offset - sizeof (uint32_t)) : std::string ();
+      }
+    bool quoted = false;
+    size_t fields = 0;
+    for (size_t i = 0; i < record.size (); ++i)
+      {
+        if (record[i] == '"')
+          {
+            quoted = !quoted;
+          }
+        else if ((record[i] == ',' || record[i] == '\n') && !quoted && ++fields == columns)
+          {
+            return record.substr (0, i);
+          }
+      }
+    return std::string ();
+  }
+
+  std::string Header (const ResultRecord &record) const
+  {
+    std::ostringstream oss;
+    if (m_binary)
+      {
+        oss << "WRATEBIN1\n";
+      }
+    for (size_t i = 0; i < record.names.size (); ++i)
+      {
+        oss << (i > 0 ? "," : "") << record.names[i];
+        if (m_binary)
+          {
+            oss << (record.isText[i] ? ":s" : ":d");
+          }
+      }
+    oss << "\n";
+    return oss.str ();
+  }
+
+  std::string EncodeRecord (const ResultRecord &record) const
+  {
+    if (!m_binary)
+      {
+        std::ostringstream oss;
+        oss.precision (10);
+        for (size_t i = 0; i < record.names.size (); ++i)
+          {
+            oss << (i > 0 ? "," : "");
+            if (record.isText[i] && record.texts[i].find_first_of (",\"\n") != std::string::npos)
+              {
+                std::string quoted = record.texts[i];
+                for (std::string::size_type q = quoted.find ('"'); q != std::string::npos; q = quoted.find ('"', q + 2))
+                  {
+                    quoted.insert (q, 1, '"');
+                  }
+                oss << '"' << quoted << '"';
+              }
+            else if (record.isText[i])
+              {
+                oss << record.texts[i];
+              }
+            else
+              {
+                oss << record.numbers[i];
+              }
+          }
+        oss << "\n";
+        return oss.str ();
+      }
+    std::string payload;
+    for (size_t i = 0; i < record.names.size (); ++i)
+      {
+        if (record.isText[i])
+          {
+            uint16_t length = record.texts[i].size ();
+            payload.append ((const char *)&length, sizeof (length));
+            payload.append (record.texts[i]);
+          }
+        else
+          {
+            payload.append ((const char *)&record.numbers[i], sizeof (double));
+          }
+      }
+    uint32_t length = payload.size ();
+    return std::string ((const char *)&length, sizeof (length)) + payload;
+  }
+
+  std::string m_fileName;
+  bool m_binary;
+};
+
+//Measurements of one run as collected by FlowOutput, throughputs are in params.throughputUnit
+struct RunResult
+{
+  double throughput; //summed over all flows
+  uint64_t txPackets;
+  uint64_t rxPackets;
+  double meanDelay; //seconds per received packet, NaN unless measured (measure=flowmon and a packet arrived)
+  double meanJitter; //seconds per received packet pair, NaN unless measured
+  uint32_t flows;
+  double jainIndex; //Jain's fairness index over the per-flow throughputs
+  double minThroughput;
+  double p10Throughput;
+  double medianThroughput;
+  double p90Throughput;
+  double maxThroughput;
+  uint64_t dataFrames; //trace counters summed over all station links
+  uint64_t rateChanges;
+  uint64_t txDataFailed;
+  uint64_t txFinalDataFailed;
+  uint64_t txRtsFailed;
+  uint64_t phyRxDrop;
+  double buildSeconds; //wall time from the start of RunScenario until Simulator::Run
+  double topologySeconds; //part of buildSeconds spent on nodes, channel, devices and mobility
+  double stackSeconds; //part of buildSeconds spent installing the internet stacks and addresses
+  double runSeconds; //wall time spent in Simulator::Run
+  double cpuSeconds; //user plus system CPU time from the start of the build to the end of the run
+  double outputSeconds; //wall time spent in FlowOutput and collecting the trace counters
+  double writeSeconds; //wall time spent encoding and appending the detail records
+  uint64_t events; //events scheduled during the run, only counted with --profile
+  double eventsPerSecond; //events per second of runSeconds
+  long peakRssKb; //peak resident set size from the start of the build to the end of the run, -1 if unknown
+};
+
+//Trace state of the running scenario in flat arrays indexed by node id. Every station has one flow
+//to or from the AP, so whatever happens on a station's link (its own frames, the AP's frames to it
+//and frames of it the AP dropped) is booked on the station's node id. The simulation is single
+//threaded, so the counters are plain integers bumped in place; nothing is logged per event.
+struct NodeTraces
+{
+  std::vector<bool> isStation;
+  std::vector<uint32_t> bssOf; //BSS index of every station and AP
+  std::vector<uint32_t> bssChannel; //channel number of every BSS
+  std::vector<uint64_t> rxBytes; //application bytes of the node's flow delivered so far
+  std::vector<uint64_t> rxPackets; //packets of the node's flow delivered so far
+  std::vector<uint64_t> txPackets; //packets of the node's flow handed to the socket by its sender
+  std::vector<uint64_t> dataRate; //bit/s of the last data frame sent on the node's link
+  std::vector<uint64_t> dataFrames; //data frame transmissions (first attempts and retries) on the node's link
+  std::vector<uint64_t> rateChanges; //data frames sent at a different rate than the previous one
+  std::vector<uint64_t> txDataFailed; //failed data frame attempts on the node's link
+  std::vector<uint64_t> txFinalDataFailed; //data frames given up after the retry limit
+  std::vector<uint64_t> txRtsFailed; //failed RTS attempts
+  std::vector<uint64_t> phyRxDrop; //frames of the link the receiving PHY dropped
+  std::vector<uint32_t> apNode; //node id of the AP of every BSS
+  std::vector<Ptr<MobilityModel> > mobility; //model of every node, positions are only worked out when sampled
+  std::vector<uint32_t> nodeByHost; //station node id by IPv4 address minus firstHost
+  uint32_t firstHost;
+  std::vector<uint32_t> nodeByMac; //station node id by MAC address minus firstMac, see MacNumber, noNode for others
+  uint64_t firstMac;
+};
+
+NodeTraces g_traces;
+const uint32_t noNode = std::numeric_limits<uint32_t>::max (); //nodeByMac entry of an address that is no station
+
+//Per-frame events of one run in a compact binary file: a FrameTraceHeader followed by fixed-size
+//FrameRecords, analysed offline by traceanalyzer.cc next to the scripts, which keeps its own copy of
+//this layout. Records go straight into a memory-mapped window of the file, so tracing a frame costs a
+//32 byte store; the kernel writes the pages back in the background.
+enum FrameEvent
+{
+  FRAME_TX, //a frame went on the air, rate is its rate
+  FRAME_RX, //a frame was received, with its SNR
+  FRAME_RX_DROP, //the PHY dropped a frame it was receiving
+  FRAME_DATA_FAILED, //no ACK for a data frame, it will be retried
+  FRAME_FINAL_FAILED, //a data frame was given up after the retry limit
+  FRAME_RTS_FAILED //no CTS for an RTS
+};
+
+enum FrameFlags
+{
+  FRAME_DATA = 1,
+  FRAME_RTS = 2,
+  FRAME_CTS = 4,
+  FRAME_ACK = 8,
+  FRAME_RETRY = 16
+};
+
+struct FrameTraceHeader
+{
+  char magic[8]; //"WIFITRC1"
+  uint32_t recordSize;
+  uint32_t headerSize;
+  uint64_t records; //written when the trace is closed
+  char run[232]; //parameters of the run as name=value pairs
+};
+
+struct FrameRecord
+{
+  double time; //simulation seconds
+  uint32_t node; //node the event happened on
+  uint32_t link; //station node id of the link, see LinkNode
+  uint32_t rateKbps; //transmitted frames: their rate, 0 otherwise
+  float snrDb; //received frames: signal to noise ratio, NaN otherwise
+  uint32_t size; //bytes of the frame, 0 for MAC failures
+  uint8_t kind; //FrameEvent
+  uint8_t flags; //FrameFlags
+  uint16_t reserved;
+};
+
+typedef char FrameRecordIs32Bytes[sizeof (FrameRecord) == 32 && sizeof (FrameTraceHeader) == 256 ? 1 : -1];
+
+class FrameTraceWriter
+{
+public:
+  FrameTraceWriter (const std::string &fileName, const std::string &run)
+    : m_fileName (fileName),
+      m_window (0),
+      m_windowStart (0),
+      m_used (0),
+      m_records (0)
+  {
+    m_fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0)
+      {
+        NS_FATAL_ERROR ("Cannot open " << fileName << ": " << strerror (errno));
+      }
+    FrameTraceHeader header;
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, "WIFITRC1", sizeof (header.magic));
+    header.recordSize = sizeof (FrameRecord);
+    header.headerSize = sizeof (FrameTraceHeader);
+    strncpy (header.run, run.c_str (), sizeof (header.run) - 1);
+    Map (0);
+    memcpy (m_window, &header, sizeof (header));
+    m_used = sizeof (header);
+  }
+  ~FrameTraceWriter ()
+  {
+    munmap (m_window, windowSize);
+    uint64_t size = sizeof (FrameTraceHeader) + m_records * sizeof (FrameRecord);
+    if (ftruncate (m_fd, size) != 0
+        || pwrite (m_fd, &m_records, sizeof (m_records), offsetof (FrameTraceHeader, records)) != sizeof (m_records))
+      {
+        std::cerr << "Cannot finish " << m_fileName << ": " << strerror (errno) << std::endl;
+      }
+    close (m_fd);
+  }
+  void Add (const FrameRecord &record)
+  {
+    if (m_used == windowSize)
+      {
+        munmap (m_window, windowSize);
+        Map (m_windowStart + windowSize);
+      }
+    memcpy (m_window + m_used, &record, sizeof (record));
+    m_used += sizeof (record);
+    ++m_records;
+  }
+
+private:
+  //A multiple of the page size and of the record size, so no record straddles two windows
+  static const size_t windowSize = 1 << 20;
+
+  //Grow the file by a window and map it
+  void Map (off_t start)
+  {
+    if (ftruncate (m_fd, start + windowSize) != 0)
+      {
+        NS_FATAL_ERROR ("Cannot grow " << m_fileName << ": " << strerror (errno));
+      }
+    void *window = mmap (0, windowSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, start);
+    if (window == MAP_FAILED)
+      {
+        NS_FATAL_ERROR ("Cannot map " << m_fileName << ": " << strerror (errno));
+      }
+    m_window = static_cast<char *> (window);
+    m_windowStart = start;
+    m_used = 0;
+  }
+
+  FrameTraceWriter (const FrameTraceWriter &);
+  FrameTraceWriter &operator= (const FrameTraceWriter &);
+
+  std::string m_fileName;
+  int m_fd;
+  char *m_window;
+  off_t m_windowStart;
+  size_t m_used; //bytes of the current window in use
+  uint64_t m_records;
+};
+
+FrameTraceWriter *g_frameTrace = 0; //trace of the running scenario, 0 when not tracing
+
+//Record one frame event on the trace, header being the MAC header of the frame, 0 for MAC failures
+void
+TraceFrame (FrameEvent kind, uint32_t node, uint32_t link, const WifiMacHeader *header, uint32_t size,
+            uint32_t rateKbps, double snrDb)
+{
+  FrameRecord record;
+  record.time = Simulator::Now ().GetSeconds ();
+  record.node = node;
+  record.link = link;
+  record.rateKbps = rateKbps;
+  record.snrDb = (float)snrDb;
+  record.size = size;
+  record.kind = kind;
+  record.flags = 0;
+  record.reserved = 0;
+  if (header != 0)
+    {
+      record.flags = (header->IsData () ? FRAME_DATA : 0) | (header->IsRts () ? FRAME_RTS : 0)
+                     | (header->IsCts () ? FRAME_CTS : 0) | (header->IsAck () ? FRAME_ACK : 0)
+                     | (header->IsRetry () ? FRAME_RETRY : 0);
+    }
+  g_frameTrace->Add (record);
+}
+
+std::string ParamsText (const ScenarioParams &params);
+std::string HashHex (const std::string &text);
+
+//Open the frame trace of a run when params asks for one, before ConnectTraces. Every run gets its own
+//file, named after frameTrace, the main sweep parameters for the reader and a hash of all parameters (see
+//ParamsText), so runs that differ in any of them, like fading, apNum or traffic, never share a file.
+void
+StartFrameTrace (const ScenarioParams &params)
+{
+  if (params.frameTrace.empty ())
+    {
+      return;
+    }
+  std::string base = params.frameTrace;
+  std::string::size_type dot = base.rfind ('.');
+  if (dot != std::string::npos && (base.rfind ('/') == std::string::npos || dot > base.rfind ('/')))
+    {
+      base = base.substr (0, dot);
+    }
+  std::ostringstream name;
+  std::string key = HashHex (ParamsText (params));
+  name << base << "-" << params.manager << (params.rayleigh ? "-rayleigh" : "") << "-d" << params.distance
+       << "-n" << params.nodeNum << "-s" << params.seed << "-" << key.substr (0, 8) << ".trc";
+  std::ostringstream run;
+  run << "key=" << key << " manager=" << params.manager << " rayleigh=" << params.rayleigh << " fading=" << params.fading
+      << " distance=" << params.distance << " nodeNum=" << params.nodeNum << " apNum=" << params.apNum
+      << " seed=" << params.seed << " stopTime=" << params.stopTime << " traffic=" << params.traffic
+      << " direction=" << params.direction << " mobility=" << params.mobility;
+  g_frameTrace = new FrameTraceWriter (name.str (), run.str ());
+}
+
+//Close the frame trace of the run, if any, once the simulation has run
+void
+StopFrameTrace (void)
+{
+  delete g_frameTrace;
+  g_frameTrace = 0;
+}
+
+//A MAC address as a number. ns-3 hands out device addresses in sequence, so the stations of a run
+//occupy a short range of numbers and nodeByMac can be a flat array over it, like nodeByHost.
+uint64_t
+MacNumber (Mac48Address address)
+{
+  uint8_t bytes[6];
+  address.CopyTo (bytes);
+  uint64_t number = 0;
+  for (int i = 0; i < 6; ++i)
+    {
+      number = (number << 8) | bytes[i];
+    }
+  return number;
+}
+
+//Node id whose link an event of `node` involving `peer` belongs to: a station's own, or on an AP that of
+//the station peer is. Broadcasts and unknown peers stay on the AP.
+uint32_t
+LinkNode (uint32_t node, Mac48Address peer)
+{
+  if (g_traces.isStation[node])
+    {
+      return node;
+    }
+  uint64_t mac = MacNumber (peer) - g_traces.firstMac;
+  return mac < g_traces.nodeByMac.size () && g_traces.nodeByMac[mac] != noNode ? g_traces.nodeByMac[mac] : node;
+}
+
+void
+OnSinkRx (uint32_t node, Ptr<const Packet> packet, const Address &from)
+{
+  uint32_t station = node;
+  if (!g_traces.isStation[node] && InetSocketAddress::IsMatchingType (from))
+    {
+      uint32_t host = InetSocketAddress::ConvertFrom (from).GetIpv4 ().Get () - g_traces.firstHost;
+      if (host < g_traces.nodeByHost.size ())
+        {
+          station = g_traces.nodeByHost[host];
+        }
+    }
+  g_traces.rxBytes[station] += packet->GetSize ();
+  ++g_traces.rxPackets[station];
+}
+
+void
+OnSenderTx (uint32_t station, Ptr<const Packet> packet)
+{
+  ++g_traces.txPackets[station];
+}
+
+void
+OnMacTxDataFailed (uint32_t node, Mac48Address peer)
+{
+  uint32_t link = LinkNode (node, peer);
+  ++g_traces.txDataFailed[link];
+  if (g_frameTrace != 0)
+    {
+      TraceFrame (FRAME_DATA_FAILED, node, link, 0, 0, 0, std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+void
+OnMacTxFinalDataFailed (uint32_t node, Mac48Address peer)
+{
+  uint32_t link = LinkNode (node, peer);
+  ++g_traces.txFinalDataFailed[link];
+  if (g_frameTrace != 0)
+    {
+      TraceFrame (FRAME_FINAL_FAILED, node, link, 0, 0, 0, std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+void
+OnMacTxRtsFailed (uint32_t node, Mac48Address peer)
+{
+  uint32_t link = LinkNode (node, peer);
+  ++g_traces.txRtsFailed[link];
+  if (g_frameTrace != 0)
+    {
+      TraceFrame (FRAME_RTS_FAILED, node, link, 0, 0, 0, std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+void
+OnMonitorSnifferTx (uint32_t node, Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                    uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu)
+{
+  WifiMacHeader header;
+  packet->PeekHeader (header);
+  if (g_frameTrace == 0 && !header.IsData ())
+    {
+      return; //control and management frames only matter to the frame trace
+    }
+  uint32_t link = LinkNode (node, header.GetAddr1 ());
+  if (g_frameTrace != 0)
+    {
+      TraceFrame (FRAME_TX, node, link, &header, packet->GetSize (), rate * 500,
+                  std::numeric_limits<double>::quiet_NaN ());
+    }
+  if (header.IsData ())
+    {
+      uint64_t bitRate = rate * 500000ULL; //rate is given in units of 500 kbit/s
+      if (g_traces.dataFrames[link] > 0 && g_traces.dataRate[link] != bitRate)
+        {
+          ++g_traces.rateChanges[link];
+        }
+      g_traces.dataRate[link] = bitRate;
+      ++g_traces.dataFrames[link];
+    }
+}
+
+//Only connected while tracing frames. Control frames without a transmitter address (CTS, ACK) are booked
+//on the receiver's own link.
+void
+OnMonitorSnifferRx (uint32_t node, Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                    uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu,
+                    struct signalNoiseDbm signalNoise)
+{
+  WifiMacHeader header;
+  packet->PeekHeader (header);
+  uint32_t link = header.IsCts () || header.IsAck () ? node : LinkNode (node, header.GetAddr2 ());
+  TraceFrame (FRAME_RX, node, link, &header, packet->GetSize (), rate * 500, signalNoise.signal - signalNoise.noise);
+}
+
+void
+OnPhyRxDrop (uint32_t node, Ptr<const Packet> packet)
+{
+  WifiMacHeader header;
+  packet->PeekHeader (header);
+  uint32_t link = LinkNode (node, header.GetAddr2 ());
+  ++g_traces.phyRxDrop[link];
+  if (g_frameTrace != 0)
+    {
+      TraceFrame (FRAME_RX_DROP, node, link, &header, packet->GetSize (), 0,
+                  std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+//Size the trace arrays for the nodes of this run and hook the trace sources of stations and APs.
+//aps.Get (k) is the AP of BSS k, stationBss[i] the BSS of stations.Get (i).
+void
+ConnectTraces (NodeContainer stations, NodeContainer aps, NetDeviceContainer staDevices,
+               Ipv4InterfaceContainer staInterfaces, Ipv4InterfaceContainer apInterfaces,
+               const std::vector<uint32_t> &stationBss, const std::vector<uint32_t> &bssChannel)
+{
+  uint32_t nodes = NodeList::GetNNodes ();
+  g_traces = NodeTraces ();
+  g_traces.isStation.assign (nodes, false);
+  g_traces.bssOf.assign (nodes, 0);
+  g_traces.bssChannel = bssChannel;
+  g_traces.mobility.assign (nodes, Ptr<MobilityModel> ());
+  for (uint32_t k = 0; k < aps.GetN (); ++k)
+    {
+      g_traces.bssOf[aps.Get (k)->GetId ()] = k;
+      g_traces.apNode.push_back (aps.Get (k)->GetId ());
+    }
+  g_traces.rxBytes.assign (nodes, 0);
+  g_traces.rxPackets.assign (nodes, 0);
+  g_traces.txPackets.assign (nodes, 0);
+  g_traces.dataRate.assign (nodes, 0);
+  g_traces.dataFrames.assign (nodes, 0);
+  g_traces.rateChanges.assign (nodes, 0);
+  g_traces.txDataFailed.assign (nodes, 0);
+  g_traces.txFinalDataFailed.assign (nodes, 0);
+  g_traces.txRtsFailed.assign (nodes, 0);
+  g_traces.phyRxDrop.assign (nodes, 0);
+
+  uint32_t firstHost = std::numeric_limits<uint32_t>::max ();
+  uint32_t lastHost = 0;
+  Ipv4InterfaceContainer interfaces = apInterfaces;
+  interfaces.Add (staInterfaces);
+  for (uint32_t i = 0; i < interfaces.GetN (); ++i)
+    {
+      firstHost = std::min (firstHost, interfaces.GetAddress (i).Get ());
+      lastHost = std::max (lastHost, interfaces.GetAddress (i).Get ());
+    }
+  g_traces.firstHost = firstHost;
+  g_traces.nodeByHost.assign (interfaces.GetN () > 0 ? lastHost - firstHost + 1 : 0, aps.Get (0)->GetId ());
+  //device i is the one of station i; its address comes from its own node's stack, so the mapping holds
+  //whatever order the nodes were created or numbered in
+  for (uint32_t i = 0; i < staDevices.GetN (); ++i)
+    {
+      Ptr<NetDevice> device = staDevices.Get (i);
+      uint32_t node = device->GetNode ()->GetId ();
+      Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+      Ipv4Address host = ipv4->GetAddress (ipv4->GetInterfaceForDevice (device), 0).GetLocal ();
+      g_traces.isStation[node] = true;
+      g_traces.bssOf[node] = stationBss[i];
+      g_traces.nodeByHost[host.Get () - firstHost] = node;
+    }
+  uint64_t firstMac = std::numeric_limits<uint64_t>::max ();
+  uint64_t lastMac = 0;
+  for (uint32_t i = 0; i < staDevices.GetN (); ++i)
+    {
+      uint64_t mac = MacNumber (Mac48Address::ConvertFrom (staDevices.Get (i)->GetAddress ()));
+      firstMac = std::min (firstMac, mac);
+      lastMac = std::max (lastMac, mac);
+    }
+  if (staDevices.GetN () > 0 && lastMac - firstMac >= 4 * (uint64_t)nodes)
+    {
+      NS_FATAL_ERROR ("station MAC addresses span " << lastMac - firstMac + 1 << " numbers for " << nodes << " nodes");
+    }
+  g_traces.firstMac = firstMac;
+  g_traces.nodeByMac.assign (staDevices.GetN () > 0 ? lastMac - firstMac + 1 : 0, noNode);
+  for (uint32_t i = 0; i < staDevices.GetN (); ++i)
+    {
+      Ptr<NetDevice> device = staDevices.Get (i);
+      g_traces.nodeByMac[MacNumber (Mac48Address::ConvertFrom (device->GetAddress ())) - firstMac] = device->GetNode ()->GetId ();
+    }
+
+  NodeContainer all = aps;
+  all.Add (stations);
+  for (uint32_t i = 0; i < all.GetN (); ++i)
+    {
+      //straight on the objects: a Config path like /NodeList/<id>/... is matched against every node in the
+      //list, which makes connecting all nodes quadratic in their number
+      uint32_t node = all.Get (i)->GetId ();
+      g_traces.mobility[node] = all.Get (i)->GetObject<MobilityModel> ();
+      for (uint32_t d = 0; d < all.Get (i)->GetNDevices (); ++d)
+        {
+          Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (all.Get (i)->GetDevice (d));
+          if (device == 0)
+            {
+              continue; //the loopback device
+            }
+          Ptr<WifiRemoteStationManager> manager = device->GetRemoteStationManager ();
+          manager->TraceConnectWithoutContext ("MacTxDataFailed", MakeBoundCallback (&OnMacTxDataFailed, node));
+          manager->TraceConnectWithoutContext ("MacTxFinalDataFailed", MakeBoundCallback (&OnMacTxFinalDataFailed, node));
+          manager->TraceConnectWithoutContext ("MacTxRtsFailed", MakeBoundCallback (&OnMacTxRtsFailed, node));
+          Ptr<WifiPhy> phy = device->GetPhy ();
+          phy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&OnMonitorSnifferTx, node));
+          phy->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&OnPhyRxDrop, node));
+          if (g_frameTrace != 0)
+            {
+              phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&OnMonitorSnifferRx, node));
+            }
+        }
+      for (uint32_t j = 0; j < all.Get (i)->GetNApplications (); ++j)
+        {
+          //senders have a Remote, one on an AP counts for the station it sends to
+          Ptr<Application> app = all.Get (i)->GetApplication (j);
+          if (DynamicCast<PacketSink> (app) != 0)
+            {
+              app->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&OnSinkRx, node));
+              continue;
+            }
+          AddressValue remote;
+          if (!app->GetAttributeFailSafe ("Remote", remote) || !InetSocketAddress::IsMatchingType (remote.Get ()))
+            {
+              continue;
+            }
+          uint32_t station = node;
+          uint32_t host = InetSocketAddress::ConvertFrom (remote.Get ()).GetIpv4 ().Get () - firstHost;
+          if (!g_traces.isStation[node] && host < g_traces.nodeByHost.size ())
+            {
+              station = g_traces.nodeByHost[host];
+            }
+          app->TraceConnectWithoutContext ("Tx", MakeBoundCallback (&OnSenderTx, station));
+        }
+    }
+}
+
+//One station at one sampling instant
+struct Sample
+{
+  double time;
+  uint32_t node;
+  uint64_t rxBytes; //delivered during the last interval
+  uint64_t dataRate;
+  uint64_t retries; //failed data frame attempts during the last interval
+  double distance; //metres to the station's AP
+};
+
+//Fixed-capacity ring of samples. All storage is allocated by Reset before the run, Push only
+//overwrites a slot, and once the ring is full the oldest samples are overwritten.
+class SampleRing
+{
+public:
+  void Reset (size_t capacity)
+  {
+    m_samples.assign (capacity, Sample ());
+    m_next = 0;
+    m_count = 0;
+    m_overwritten = 0;
+  }
+  void Push (const Sample &sample)
+  {
+    if (m_samples.empty ())
+      {
+        return;
+      }
+    m_samples[m_next] = sample;
+    m_next = (m_next + 1) % m_samples.size ();
+    if (m_count < m_samples.size ())
+      {
+        ++m_count;
+      }
+    else
+      {
+        ++m_overwritten;
+      }
+  }
+  size_t GetN (void) const
+  {
+    return m_count;
+  }
+  //i-th oldest sample still held
+  const Sample &Get (size_t i) const
+  {
+    return m_samples[(m_next + m_samples.size () - m_count + i) % m_samples.size ()];
+  }
+  uint64_t GetOverwritten (void) const
+  {
+    return m_overwritten;
+  }
+
+private:
+  std::vector<Sample> m_samples;
+  size_t m_next;
+  size_t m_count;
+  uint64_t m_overwritten;
+};
+
+SampleRing g_samples;
+std::vector<uint64_t> g_sampledRxBytes; //rxBytes per node at the previous sample
+std::vector<uint64_t> g_sampledFailed; //txDataFailed per node at the previous sample
+double g_sampleStart; //simulation time the sampler started, sample times are relative to it
+
+//Periodic sampler: books one Sample per station and reschedules itself
+void
+TakeSamples (double interval)
+{
+  Sample sample;
+  sample.time = Simulator::Now ().GetSeconds () - g_sampleStart;
+  for (uint32_t node = 0; node < g_traces.isStation.size (); ++node)
+    {
+      if (!g_traces.isStation[node])
+        {
+          continue;
+        }
+      sample.node = node;
+      sample.rxBytes = g_traces.rxBytes[node] - g_sampledRxBytes[node];
+      sample.dataRate = g_traces.dataRate[node];
+      sample.retries = g_traces.txDataFailed[node] - g_sampledFailed[node];
+      sample.distance = CalculateDistance (g_traces.mobility[node]->GetPosition (),
+                                           g_traces.mobility[g_traces.apNode[g_traces.bssOf[node]]]->GetPosition ());
+      g_sampledRxBytes[node] = g_traces.rxBytes[node];
+      g_sampledFailed[node] = g_traces.txDataFailed[node];
+      g_samples.Push (sample);
+    }
+  Simulator::Schedule (Seconds (interval), &TakeSamples, interval);
+}
+
+//Preallocate the ring for the whole run (or `capacity` samples when given) and schedule the first sample
+void
+StartSampler (double interval, int capacity, uint32_t stations, double stopTime)
+{
+  g_sampledRxBytes.assign (g_traces.rxBytes.size (), 0);
+  g_sampledFailed.assign (g_traces.txDataFailed.size (), 0);
+  if (capacity <= 0)
+    {
+      capacity = stations * ((int)(stopTime / interval) + 1);
+    }
+  g_samples.Reset (capacity);
+  g_sampleStart = Simulator::Now ().GetSeconds ();
+  Simulator::Schedule (Seconds (interval), &TakeSamples, interval);
+}
+
+//Turn the held samples into detail records in one go once the run is over
+void
+FlushSamples (double interval, std::vector<ResultRecord> &records)
+{
+  if (g_samples.GetOverwritten () > 0)
+    {
+      std::cerr << "Sample ring overwrote " << g_samples.GetOverwritten () << " samples, raise sampleCapacity" << std::endl;
+    }
+  records.reserve (g_samples.GetN ());
+  for (size_t i = 0; i < g_samples.GetN (); ++i)
+    {
+      const Sample &sample = g_samples.Get (i);
+      ResultRecord record;
+      record.Add ("time", sample.time);
+      record.Add ("node", sample.node);
+      record.Add ("rxBytes", sample.rxBytes);
+      record.Add ("throughputMbps", sample.rxBytes * 8.0 / interval / 1e6);
+      record.Add ("dataRateMbps", sample.dataRate / 1e6);
+      record.Add ("retries", sample.retries);
+      record.Add ("distance", sample.distance);
+      records.push_back (record);
+    }
+  g_samples.Reset (0);
+}
+
+//Fold the trace counters into the run result and add one summary record per station
+void
+FlushStationCounters (RunResult &result, bool print, std::vector<ResultRecord> &records)
+{
+  for (uint32_t node = 0; node < g_traces.isStation.size (); ++node)
+    {
+      if (!g_traces.isStation[node])
+        {
+          continue;
+        }
+      result.dataFrames += g_traces.dataFrames[node];
+      result.rateChanges += g_traces.rateChanges[node];
+      result.txDataFailed += g_traces.txDataFailed[node];
+      result.txFinalDataFailed += g_traces.txFinalDataFailed[node];
+      result.txRtsFailed += g_traces.txRtsFailed[node];
+      result.phyRxDrop += g_traces.phyRxDrop[node];
+
+      ResultRecord record;
+      record.Add ("node", node);
+      record.Add ("rxBytes", g_traces.rxBytes[node]);
+      record.Add ("lastDataRateMbps", g_traces.dataRate[node] / 1e6);
+      record.Add ("dataFrames", g_traces.dataFrames[node]);
+      record.Add ("rateChanges", g_traces.rateChanges[node]);
+      record.Add ("txDataFailed", g_traces.txDataFailed[node]);
+      record.Add ("txFinalDataFailed", g_traces.txFinalDataFailed[node]);
+      record.Add ("txRtsFailed", g_traces.txRtsFailed[node]);
+      record.Add ("phyRxDrop", g_traces.phyRxDrop[node]);
+      records.push_back (record);
+      if (print)
+        {
+          std::cout << "Station " << node << ": rx " << g_traces.rxBytes[node] << " B, rate "
+                    << g_traces.dataRate[node] / 1e6 << " Mbps, data frames " << g_traces.dataFrames[node]
+                    << ", rate changes " << g_traces.rateChanges[node] << ", data failed " << g_traces.txDataFailed[node]
+                    << " (final " << g_traces.txFinalDataFailed[node] << "), rts failed " << g_traces.txRtsFailed[node]
+                    << ", phy rx drop " << g_traces.phyRxDrop[node] << std::endl;
+        }
+    }
+}
+
+//Events scheduled in this process per EventImpl type, counted by ProfilingSimulatorImpl
+std::map<const char *, uint64_t> g_eventCounts;
+
+//The default simulator, additionally counting every scheduled event by the type of its EventImpl. The
+//type is the MakeEvent wrapper of the scheduled function, so it tells events apart by the signature
+//of what they call. Selected with --profile through SimulatorImplementationType.
+class ProfilingSimulatorImpl : public DefaultSimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::ProfilingSimulatorImpl")
+      .SetParent<DefaultSimulatorImpl> ()
+      .AddConstructor<ProfilingSimulatorImpl> ();
+    return tid;
+  }
+
+  virtual EventId Schedule (Time const &delay, EventImpl *event)
+  {
+    ++g_eventCounts[typeid (*event).name ()];
+    return DefaultSimulatorImpl::Schedule (delay, event);
+  }
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+  {
+    ++g_eventCounts[typeid (*event).name ()];
+    DefaultSimulatorImpl::ScheduleWithContext (context, delay, event);
+  }
+  virtual EventId ScheduleNow (EventImpl *event)
+  {
+    ++g_eventCounts[typeid (*event).name ()];
+    return DefaultSimulatorImpl::ScheduleNow (event);
+  }
+  virtual EventId ScheduleDestroy (EventImpl *event)
+  {
+    ++g_eventCounts[typeid (*event).name ()];
+    return DefaultSimulatorImpl::ScheduleDestroy (event);
+  }
+};
+NS_OBJECT_ENSURE_REGISTERED (ProfilingSimulatorImpl);
+
+//Move the event counts of the run into result and into one record per event type, most frequent first
+void
+FlushEventCounts (RunResult &result, std::vector<ResultRecord> &records)
+{
+  std::vector<std::pair<uint64_t, std::string> > counts;
+  for (std::map<const char *, uint64_t>::const_iterator it = g_eventCounts.begin (); it != g_eventCounts.end (); ++it)
+    {
+      int status = 0;
+      char *name = abi::__cxa_demangle (it->first, 0, 0, &status);
+      counts.push_back (std::make_pair (it->second, status == 0 ? std::string (name) : std::string (it->first)));
+      free (name);
+      result.events += it->second;
+    }
+  g_eventCounts.clear ();
+  std::sort (counts.rbegin (), counts.rend ());
+  for (size_t i = 0; i < counts.size (); ++i)
+    {
+      ResultRecord record;
+      record.AddText ("eventType", counts[i].second);
+      record.Add ("events", counts[i].first);
+      records.push_back (record);
+    }
+  result.eventsPerSecond = result.runSeconds > 0.0 ? result.events / result.runSeconds : 0.0;
+}
+
+//SplitMix64 finaliser, the mixing function of the counter-based generator of the fading models
+inline uint64_t
+MixBits (uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+//Node id of the mobility models a propagation loss model sees, from an open-addressing hash of the
+//model's address that is filled from the NodeList once, when the first model shows up that it does not
+//know. A lookup is a hash and usually a single probe, the ids being those of the nodes they stay the same
+//whatever order the links are first used in.
+class NodeIndex
+{
+public:
+  uint32_t Get (Ptr<MobilityModel> mobility)
+  {
+    uint32_t node = 0;
+    if (!Find (PeekPointer (mobility), node))
+      {
+        Fill ();
+        if (!Find (PeekPointer (mobility), node))
+          {
+            NS_FATAL_ERROR ("propagation loss of a mobility model on no node");
+          }
+      }
+    return node;
+  }
+
+private:
+  bool Find (const MobilityModel *mobility, uint32_t &node) const
+  {
+    if (m_models.empty ())
+      {
+        return false;
+      }
+    for (size_t slot = Slot (mobility); m_models[slot] != 0; slot = (slot + 1) & (m_models.size () - 1))
+      {
+        if (m_models[slot] == mobility)
+          {
+            node = m_nodes[slot];
+            return true;
+          }
+      }
+    return false;
+  }
+
+  size_t Slot (const MobilityModel *mobility) const
+  {
+    return (size_t)MixBits ((uint64_t)(size_t)mobility) & (m_models.size () - 1);
+  }
+
+  //Hash the mobility model of every node, at most half filling the table
+  void Fill (void)
+  {
+    size_t size = 16;
+    while (size < 2 * (size_t)NodeList::GetNNodes ())
+      {
+        size *= 2;
+      }
+    m_models.assign (size, 0);
+    m_nodes.assign (size, 0);
+    for (uint32_t node = 0; node < NodeList::GetNNodes (); ++node)
+      {
+        Ptr<MobilityModel> mobility = NodeList::GetNode (node)->GetObject<MobilityModel> ();
+        if (mobility == 0)
+          {
+            continue;
+          }
+        size_t slot = Slot (PeekPointer (mobility));
+        while (m_models[slot] != 0)
+          {
+            slot = (slot + 1) & (size - 1);
+          }
+        m_models[slot] = PeekPointer (mobility);
+        m_nodes[slot] = node;
+      }
+  }
+
+  std::vector<const MobilityModel *> m_models; //0 for an empty slot
+  std::vector<uint32_t> m_nodes;
+};
+
+//The station-AP links of a scenario, the only node pairs the loss models keep state for, so that it stays
+//linear in the nodes. Set from peer[node], the AP node of station node and node itself for the APs.
+class StationLinks
+{
+public:
+  void Set (const std::vector<uint32_t> &peer)
+  {
+    m_peer = peer;
+  }
+  //Whether from and to are a station and its AP, station then being the station
+  bool Find (uint32_t from, uint32_t to, uint32_t &station) const
+  {
+    if (from < m_peer.size () && m_peer[from] == to && from != to)
+      {
+        station = from;
+        return true;
+      }
+    if (to < m_peer.size () && m_peer[to] == from && from != to)
+      {
+        station = to;
+        return true;
+      }
+    return false;
+  }
+
+private:
+  std::vector<uint32_t> m_peer;
+};
+
+const uint32_t lossCacheNodes = 1024; //most nodes the loss cache keeps a matrix of all links for, 8 MB
+
+//Log-distance loss remembered per (transmitter, receiver) pair in one contiguous matrix indexed by node id,
+//so a static topology computes every link once instead of once per frame and receiver. Above lossCacheNodes
+//nodes the matrix would grow quadratically, so only the two directions of every station-AP link (see
+//SetPeers) are kept then, which carry the data and acks, and the other links are computed per frame. The
+//cached value is the received power the wrapped model returned for the same transmit power, so results are
+//unchanged; a new transmit power recomputes the row of the transmitter, or the link. Positions are not checked on every frame: whoever
+//moves a node calls Clear, and BuildScenario does not use this model for moving stations. Models further
+//down the chain, like the Nakagami fading, still run for every frame.
+class CachedLogDistancePropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::CachedLogDistancePropagationLossModel")
+      .SetParent<PropagationLossModel> ()
+      .AddConstructor<CachedLogDistancePropagationLossModel> ()
+      .AddAttribute ("Exponent", "Path loss exponent of the wrapped log-distance loss",
+                     DoubleValue (3.0),
+                     MakeDoubleAccessor (&CachedLogDistancePropagationLossModel::SetExponent,
+                                         &CachedLogDistancePropagationLossModel::GetExponent),
+                     MakeDoubleChecker<double> ());
+    return tid;
+  }
+
+  CachedLogDistancePropagationLossModel ()
+    : m_model (CreateObject<LogDistancePropagationLossModel> ()),
+      m_nodes (0)
+  {
+  }
+
+  //Tell the model the AP of every station: peer[node] is the AP node of station node, node itself otherwise
+  void SetPeers (const std::vector<uint32_t> &peer)
+  {
+    m_links.Set (peer);
+    m_linkRxPowerDbm.assign (2 * peer.size (), std::numeric_limits<double>::quiet_NaN ());
+    m_linkTxPowerDbm.assign (2 * peer.size (), std::numeric_limits<double>::quiet_NaN ());
+  }
+
+  //Forget every cached link, after stations have been moved
+  void Clear (void)
+  {
+    std::fill (m_rxPowerDbm.begin (), m_rxPowerDbm.end (), std::numeric_limits<double>::quiet_NaN ());
+    std::fill (m_linkRxPowerDbm.begin (), m_linkRxPowerDbm.end (), std::numeric_limits<double>::quiet_NaN ());
+  }
+
+  void SetExponent (double exponent)
+  {
+    m_model->SetPathLossExponent (exponent);
+    Clear ();
+  }
+
+  double GetExponent (void) const
+  {
+    return m_model->GetPathLossExponent ();
+  }
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    double *rxPowerDbm = Entry (Index (a), Index (b), txPowerDbm);
+    if (rxPowerDbm == 0)
+      {
+        return m_model->CalcRxPower (txPowerDbm, a, b); //not a cached link
+      }
+    if (*rxPowerDbm != *rxPowerDbm)
+      {
+        *rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+      }
+    return *rxPowerDbm;
+  }
+
+  //Cached received power of the link from-to at txPowerDbm, NaN until computed, 0 when the link is not kept
+  double *Entry (uint32_t from, uint32_t to, double txPowerDbm) const
+  {
+    double nan = std::numeric_limits<double>::quiet_NaN ();
+    if (m_nodes <= lossCacheNodes)
+      {
+        if (m_txPowerDbm[from] != txPowerDbm)
+          {
+            std::fill (m_rxPowerDbm.begin () + (size_t)from * m_nodes, m_rxPowerDbm.begin () + (size_t)(from + 1) * m_nodes, nan);
+            m_txPowerDbm[from] = txPowerDbm;
+          }
+        return &m_rxPowerDbm[(size_t)from * m_nodes + to];
+      }
+    uint32_t station;
+    if (!m_links.Find (from, to, station))
+      {
+        return 0;
+      }
+    size_t link = 2 * (size_t)station + (from == station ? 0 : 1); //uplink, then downlink
+    if (m_linkTxPowerDbm[link] != txPowerDbm)
+      {
+        m_linkRxPowerDbm[link] = nan;
+        m_linkTxPowerDbm[link] = txPowerDbm;
+      }
+    return &m_linkRxPowerDbm[link];
+  }
+
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+
+  //Matrix index of a mobility model, its node id, sizing the matrix for all nodes on first use
+  uint32_t Index (Ptr<MobilityModel> mobility) const
+  {
+    uint32_t index = m_index.Get (mobility);
+    if (index >= m_nodes)
+      {
+        Resize (std::max<uint32_t> (index + 1, NodeList::GetNNodes ()));
+      }
+    return index;
+  }
+
+  //Make room for nodes nodes, forgetting the matrix of links, which is only kept for up to lossCacheNodes
+  void Resize (uint32_t nodes) const
+  {
+    double nan = std::numeric_limits<double>::quiet_NaN ();
+    m_nodes = nodes;
+    if (nodes <= lossCacheNodes)
+      {
+        m_rxPowerDbm.assign ((size_t)nodes * nodes, nan);
+        m_txPowerDbm.assign (nodes, nan);
+      }
+    else
+      {
+        std::vector<double> ().swap (m_rxPowerDbm);
+        std::vector<double> ().swap (m_txPowerDbm);
+      }
+  }
+
+  Ptr<LogDistancePropagationLossModel> m_model;
+  mutable NodeIndex m_index;
+  mutable uint32_t m_nodes;
+  mutable std::vector<double> m_rxPowerDbm; //row transmitter, column receiver, NaN until computed
+  mutable std::vector<double> m_txPowerDbm; //transmit power the row of every transmitter was computed for
+  StationLinks m_links;
+  mutable std::vector<double> m_linkRxPowerDbm; //above lossCacheNodes: 2 * station + 0 uplink, + 1 downlink
+  mutable std::vector<double> m_linkTxPowerDbm; //transmit power of every station-AP link the entry is for
+};
+NS_OBJECT_ENSURE_REGISTERED (CachedLogDistancePropagationLossModel);
+
+//Rayleigh fading with the statistics of NakagamiPropagationLossModel at m=1: the received power is
+//scaled by an Exp(1) power gain drawn independently for every frame and receiver, from a counter-based
+//generator instead of calls through the RandomVariableStream interface. The gains of every station-AP
+//link (see SetPeers) are generated batchSize at a time into a buffer of the station and handed out one per
+//frame, so memory is bounded by one batch per station. Other links, which only carry interference and
+//carrier sense, keep nothing: their gain is a hash of link and transmit time. That tells their frames
+//apart because a PHY starts no frame while it is transmitting and every frame lasts at least its
+//preamble, so one transmitter never starts two frames in the same time step. Reproducible per seed and
+//run, AssignStreams rekeys it.
+class BatchRayleighPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BatchRayleighPropagationLossModel")
+      .SetParent<PropagationLossModel> ()
+      .AddConstructor<BatchRayleighPropagationLossModel> ();
+    return tid;
+  }
+
+  BatchRayleighPropagationLossModel ()
+  {
+    Restart (RngSeedManager::GetNextStreamIndex ());
+  }
+
+  //Tell the model the AP of every station: peer[node] is the AP node of station node, node itself otherwise
+  void SetPeers (const std::vector<uint32_t> &peer)
+  {
+    GainBatch empty;
+    empty.next = batchSize;
+    empty.batches = 0;
+    m_links.Set (peer);
+    m_batches.assign (peer.size (), empty);
+  }
+
+private:
+  static const int batchSize = 64; //gains generated at once per station-AP link
+
+  //Pre-generated gains of the link of a station to its AP
+  struct GainBatch
+  {
+    double gainDb[batchSize];
+    int next; //next gain to hand out, batchSize once all are used
+    uint64_t batches; //batches generated so far, the frame counter of the link in batchSize steps
+  };
+
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    uint32_t from = m_index.Get (a);
+    uint32_t to = m_index.Get (b);
+    uint32_t station = 0;
+    if (m_links.Find (from, to, station))
+      {
+        GainBatch &batch = m_batches[station];
+        if (batch.next == batchSize)
+          {
+            Generate (station, batch);
+          }
+        return txPowerDbm + batch.gainDb[batch.next++];
+      }
+    uint64_t link = ((uint64_t)from << 32) | to;
+    return txPowerDbm + GainDb (MixBits (MixBits (m_key ^ MixBits (link)) + (uint64_t)Simulator::Now ().GetTimeStep ()));
+  }
+
+  //Fill the next batch of the link of station, keyed apart from the hashed links by m_batchKey
+  void Generate (uint32_t station, GainBatch &batch) const
+  {
+    uint64_t key = MixBits (m_batchKey ^ MixBits (station)) + batch.batches * batchSize;
+    for (int i = 0; i < batchSize; ++i)
+      {
+        batch.gainDb[i] = GainDb (MixBits (key + i));
+      }
+    batch.next = 0;
+    ++batch.batches;
+  }
+
+  //Exp(1) power gain in dB from 64 random bits
+  static double GainDb (uint64_t bits)
+  {
+    double u = ((bits >> 11) + 0.5) / 9007199254740992.0; //uniform in (0,1)
+    return 10.0 * std::log10 (-std::log (u));
+  }
+
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    Restart (stream);
+    return 1;
+  }
+
+  //Key the generator to the current seed and run and the given stream and drop every generated gain
+  void Restart (int64_t stream)
+  {
+    m_key = MixBits (MixBits (MixBits (RngSeedManager::GetSeed ()) ^ RngSeedManager::GetRun ()) ^ (uint64_t)stream);
+    m_batchKey = MixBits (m_key + 1);
+    for (size_t station = 0; station < m_batches.size (); ++station)
+      {
+        m_batches[station].next = batchSize;
+        m_batches[station].batches = 0;
+      }
+  }
+
+  mutable NodeIndex m_index;
+  uint64_t m_key;
+  uint64_t m_batchKey;
+  StationLinks m_links;
+  mutable std::vector<GainBatch> m_batches; //by station node id, unused for the APs
+};
+NS_OBJECT_ENSURE_REGISTERED (BatchRayleighPropagationLossModel);
+
+//Two independent N(0,1/2) values from two hashes by Box-Muller, the real and imaginary part of a CN(0,1)
+//channel gain whose power gain |h|^2 is Exp(1)
+inline void
+ComplexGain (uint64_t bits1, uint64_t bits2, double &re, double &im)
+{
+  double u1 = ((bits1 >> 11) + 0.5) / 9007199254740992.0;
+  double u2 = ((bits2 >> 11) + 0.5) / 9007199254740992.0;
+  double r = std::sqrt (-std::log (u1));
+  re = r * std::cos (2.0 * M_PI * u2);
+  im = r * std::sin (2.0 * M_PI * u2);
+}
+
+//Rayleigh fading that is correlated over time, with the same Exp(1) power gain per frame as the m=1
+//Nakagami model. Every link, the same in both directions, carries a complex gain. Without Autoregressive
+//the gain is held for blocks of CoherenceTime and redrawn for the next block, as a hash of the link and
+//the block index. With it the link between a station and its AP (see SetPeers) follows an AR(1) process,
+//h' = rho h + sqrt (1 - rho^2) w, with rho = J0 (2 pi fd dt) the Jakes autocorrelation over the time since
+//the last use and the Doppler fd = 0.423 / CoherenceTime; the other links, which only carry interference
+//and carrier sense, are held per block as without Autoregressive.
+//The gain of every station-AP link is kept once per station, so it is drawn once per block (or evolved
+//once per instant it is used) however many frames it carries. Other links are not kept, which would take
+//memory quadratic in the nodes: their gain is the same hash of link and block on every call, of which
+//only the power is worked out. Draws come from the counter-based generator of the batch model.
+class CoherentRayleighPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::CoherentRayleighPropagationLossModel")
+      .SetParent<PropagationLossModel> ()
+      .AddConstructor<CoherentRayleighPropagationLossModel> ()
+      .AddAttribute ("CoherenceTime", "Seconds a channel gain stays roughly the same",
+                     DoubleValue (0.05),
+                     MakeDoubleAccessor (&CoherentRayleighPropagationLossModel::m_coherenceTime),
+                     MakeDoubleChecker<double> (0.0))
+      .AddAttribute ("Autoregressive", "Evolve the gain as a Jakes AR(1) process instead of holding it per block",
+                     BooleanValue (false),
+                     MakeBooleanAccessor (&CoherentRayleighPropagationLossModel::m_autoregressive),
+                     MakeBooleanChecker ());
+    return tid;
+  }
+
+  CoherentRayleighPropagationLossModel ()
+    : m_coherenceTime (0.05),
+      m_autoregressive (false)
+  {
+    Restart (RngSeedManager::GetNextStreamIndex ());
+  }
+
+  //Tell the model the AP of every station: peer[node] is the AP node of station node, node itself otherwise
+  void SetPeers (const std::vector<uint32_t> &peer)
+  {
+    LinkGain unused = { 0.0, 0.0, 0.0, 0.0, -1 };
+    m_links.Set (peer);
+    m_gains.assign (peer.size (), unused);
+  }
+
+private:
+  //Channel gain of the link of a station to its AP and when it was last evolved
+  struct LinkGain
+  {
+    double re;
+    double im;
+    double gainDb; //10 log10 |h|^2 of re and im
+    double time; //simulation time of the last update
+    int64_t draws; //AR(1): updates so far, block: the block gainDb is for; -1 before the first
+  };
+
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    uint32_t from = m_index.Get (a);
+    uint32_t to = m_index.Get (b);
+    uint32_t low = std::min (from, to);
+    uint32_t high = std::max (from, to);
+    uint64_t key = MixBits (m_key ^ MixBits (((uint64_t)low << 32) | high));
+    double now = Simulator::Now ().GetSeconds ();
+    uint32_t station = 0;
+    if (!m_links.Find (from, to, station))
+      {
+        return txPowerDbm + BlockGainDb (key, (int64_t)std::floor (now / m_coherenceTime));
+      }
+    LinkGain &gain = m_gains[station];
+    if (!m_autoregressive)
+      {
+        int64_t block = (int64_t)std::floor (now / m_coherenceTime);
+        if (gain.draws != block)
+          {
+            gain.gainDb = BlockGainDb (key, block);
+            gain.draws = block;
+          }
+        return txPowerDbm + gain.gainDb;
+      }
+    if (gain.draws < 0)
+      {
+        ComplexGain (MixBits (key), MixBits (key + 1), gain.re, gain.im);
+        gain.gainDb = 10.0 * std::log10 (gain.re * gain.re + gain.im * gain.im);
+        gain.draws = 1;
+        gain.time = now;
+      }
+    else if (now > gain.time)
+      {
+        double rho = j0 (2.0 * M_PI * 0.423 / m_coherenceTime * (now - gain.time));
+        double scale = std::sqrt (std::max (0.0, 1.0 - rho * rho));
+        double re;
+        double im;
+        ComplexGain (MixBits (key + 2 * gain.draws), MixBits (key + 2 * gain.draws + 1), re, im);
+        gain.re = rho * gain.re + scale * re;
+        gain.im = rho * gain.im + scale * im;
+        gain.gainDb = 10.0 * std::log10 (gain.re * gain.re + gain.im * gain.im);
+        ++gain.draws;
+        gain.time = now;
+      }
+    return txPowerDbm + gain.gainDb;
+  }
+
+  //Power gain in dB of a link held for a block: |h|^2 of the complex gain ComplexGain would draw from
+  //the same hashes, which is -log of the first uniform, so the phase is never computed
+  static double BlockGainDb (uint64_t key, int64_t block)
+  {
+    double u = ((MixBits (key + 2 * block) >> 11) + 0.5) / 9007199254740992.0;
+    return 10.0 * std::log10 (-std::log (u));
+  }
+
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    Restart (stream);
+    return 1;
+  }
+
+  //Key the generator to the current seed and run and the given stream and forget every link gain
+  void Restart (int64_t stream)
+  {
+    m_key = MixBits (MixBits (MixBits (RngSeedManager::GetSeed ()) ^ RngSeedManager::GetRun ()) ^ (uint64_t)stream);
+    for (size_t station = 0; station < m_gains.size (); ++station)
+      {
+        m_gains[station].draws = -1;
+      }
+  }
+
+  double m_coherenceTime;
+  bool m_autoregressive;
+  mutable NodeIndex m_index;
+  uint64_t m_key;
+  StationLinks m_links;
+  mutable std::vector<LinkGain> m_gains; //gain of the link of every station node to its AP
+};
+NS_OBJECT_ENSURE_REGISTERED (CoherentRayleighPropagationLossModel);
+
+//Station node a flow belongs to, found by looking up its source and then its destination address
+uint32_t
+FlowStation (Ipv4Address source, Ipv4Address destination)
+{
+  uint32_t hosts[2] = { source.Get (), destination.Get () };
+  for (int k = 0; k < 2; ++k)
+    {
+      uint32_t host = hosts[k] - g_traces.firstHost;
+      if (host < g_traces.nodeByHost.size () && g_traces.isStation[g_traces.nodeByHost[host]])
+        {
+          return g_traces.nodeByHost[host];
+        }
+    }
+  return std::numeric_limits<uint32_t>::max ();
+}
+
+//Non-empty bins of a flow monitor histogram as "binStart:count|binStart:count..."
+std::string
+HistogramString (Histogram histogram)
+{
+  std::ostringstream oss;
+  for (uint32_t bin = 0; bin < histogram.GetNBins (); ++bin)
+    {
+      if (histogram.GetBinCount (bin) > 0)
+        {
+          oss << (oss.tellp () > 0 ? "|" : "") << histogram.GetBinStart (bin) << ":" << histogram.GetBinCount (bin);
+        }
+    }
+  return oss.str ();
+}
+
+//Linearly interpolated percentile of already sorted values, q in [0, 1]
+double
+Percentile (const std::vector<double> &sorted, double q)
+{
+  if (sorted.empty ())
+    {
+      return 0.0;
+    }
+  double position = q * (sorted.size () - 1);
+  size_t below = (size_t)position;
+  if (below + 1 >= sorted.size ())
+    {
+      return sorted.back ();
+    }
+  return sorted[below] + (position - below) * (sorted[below + 1] - sorted[below]);
+}
+
+//Sum, fairness and spread of the per-flow throughputs into result and one record per BSS with the same
+//aggregates over its flows into bssRecords. flowBss[i] is the BSS of the flow with throughputs[i].
+void
+SummarizeFlows (RunResult &result, std::vector<double> throughputs, const std::vector<uint32_t> &flowBss,
+                std::vector<ResultRecord> &bssRecords)
+{
+  double throughputSquares = 0.0;
+  size_t bssNum = std::max<size_t> (g_traces.bssChannel.size (), 1);
+  std::vector<uint32_t> bssFlows (bssNum, 0);
+  std::vector<double> bssSum (bssNum, 0.0);
+  std::vector<double> bssSquares (bssNum, 0.0);
+  std::vector<double> bssMin (bssNum, 0.0);
+  std::vector<double> bssMax (bssNum, 0.0);
+  for (size_t i = 0; i < throughputs.size (); ++i)
+    {
+      double throughput = throughputs[i];
+      uint32_t bss = flowBss[i];
+      result.throughput += throughput;
+      throughputSquares += throughput * throughput;
+      bssMin[bss] = bssFlows[bss] == 0 ? throughput : std::min (bssMin[bss], throughput);
+      bssMax[bss] = bssFlows[bss] == 0 ? throughput : std::max (bssMax[bss], throughput);
+      ++bssFlows[bss];
+      bssSum[bss] += throughput;
+      bssSquares[bss] += throughput * throughput;
+    }
+
+  result.flows = throughputs.size ();
+  if (throughputSquares > 0.0)
+    {
+      result.jainIndex = result.throughput * result.throughput / (throughputs.size () * throughputSquares);
+    }
+  std::sort (throughputs.begin (), throughputs.end ());
+  if (!throughputs.empty ())
+    {
+      result.minThroughput = throughputs.front ();
+      result.maxThroughput = throughputs.back ();
+    }
+  result.p10Throughput = Percentile (throughputs, 0.1);
+  result.medianThroughput = Percentile (throughputs, 0.5);
+  result.p90Throughput = Percentile (throughputs, 0.9);
+
+  for (size_t bss = 0; bss < bssNum; ++bss)
+    {
+      ResultRecord record;
+      record.Add ("bss", bss);
+      record.Add ("channel", bss < g_traces.bssChannel.size () ? g_traces.bssChannel[bss] : 0);
+      record.Add ("flows", bssFlows[bss]);
+      record.Add ("throughput", bssSum[bss]);
+      record.Add ("jainIndex", bssSquares[bss] > 0.0 ? bssSum[bss] * bssSum[bss] / (bssFlows[bss] * bssSquares[bss]) : 0.0);
+      record.Add ("minThroughput", bssMin[bss]);
+      record.Add ("maxThroughput", bssMax[bss]);
+      bssRecords.push_back (record);
+    }
+}
+
+//Walk the flow monitor stats once. Sums and fairness aggregates go into the returned RunResult,
+//one record per flow (every station has exactly one flow to or from its AP) is added to flows and
+//one record per BSS with the same aggregates over the flows of that BSS is added to bssRecords.
+RunResult
+FlowOutput(const ScenarioParams &params, Ptr<FlowMonitor> flowmon, FlowMonitorHelper &flowmonHelper,
+           std::vector<ResultRecord> &flows, std::vector<ResultRecord> &bssRecords)
+{
+  RunResult result;
+  memset (&result, 0, sizeof (result));
+  double delaySum = 0.0;
+  double jitterSum = 0.0;
+  uint64_t jitterSamples = 0;
+  std::vector<double> throughputs;
+  std::vector<uint32_t> flowBss;
+  flowmon->CheckForLostPackets (); //check all packets have been sent or completely lost
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmonHelper.GetClassifier ());
+  std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats (); // pull stats from flow monitor
+
+  for (std::map<FlowId, FlowMonitor::FlowStats>::iterator iter = stats.begin (); iter != stats.end (); ++iter)
+  {
+    Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (iter->first);
+    if (t.destinationPort != params.port)
+      {
+        continue; //acknowledgements of a TCP flow
+      }
+    FlowMonitor::FlowStats &flow = iter->second;
+    double throughput = ThroughputOf (flow.rxBytes, params);
+
+    result.txPackets += flow.txPackets;
+    result.rxPackets += flow.rxPackets;
+    delaySum += flow.delaySum.GetSeconds ();
+    jitterSum += flow.jitterSum.GetSeconds ();
+    if (flow.rxPackets > 1)
+      {
+        jitterSamples += flow.rxPackets - 1;
+      }
+    uint32_t station = FlowStation (t.sourceAddress, t.destinationAddress);
+    uint32_t bss = station < g_traces.bssOf.size () ? g_traces.bssOf[station] : 0;
+    throughputs.push_back (throughput);
+    flowBss.push_back (bss);
+
+    std::ostringstream source, destination;
+    source << t.sourceAddress;
+    destination << t.destinationAddress;
+    ResultRecord record;
+    record.Add ("flowId", iter->first);
+    record.AddText ("source", source.str ());
+    record.AddText ("destination", destination.str ());
+    record.Add ("node", station < g_traces.bssOf.size () ? (double)station : -1.0);
+    record.Add ("bss", bss);
+    record.Add ("txPackets", flow.txPackets);
+    record.Add ("rxPackets", flow.rxPackets);
+    record.Add ("txBytes", flow.txBytes);
+    record.Add ("rxBytes", flow.rxBytes);
+    record.Add ("throughput", throughput);
+    record.Add ("delaySum", flow.delaySum.GetSeconds ());
+    record.Add ("jitterSum", flow.jitterSum.GetSeconds ());
+    record.Add ("lostPackets", flow.lostPackets);
+    record.Add ("timesForwarded", flow.timesForwarded);
+    record.AddText ("delayHistogram", HistogramString (flow.delayHistogram));
+    record.AddText ("jitterHistogram", HistogramString (flow.jitterHistogram));
+    flows.push_back (record);
+  }
+
+  result.meanDelay = result.rxPackets > 0 ? delaySum / result.rxPackets : std::numeric_limits<double>::quiet_NaN ();
+  result.meanJitter = jitterSamples > 0 ? jitterSum / jitterSamples : std::numeric_limits<double>::quiet_NaN ();
+  SummarizeFlows (result, throughputs, flowBss, bssRecords);
+  return result;
+}
+
+//The same results as FlowOutput from the per-station sender and packet sink counters of ConnectTraces,
+//which cost one increment per packet instead of FlowMonitor's per-packet tracking. The sinks see payload
+//bytes, UDP flows add their 28 header bytes per packet so throughput matches FlowMonitor's IP bytes; bulk
+//TCP flows count payload only. Delay and jitter are not measured.
+RunResult
+ProbeOutput (const ScenarioParams &params, std::vector<ResultRecord> &flows, std::vector<ResultRecord> &bssRecords)
+{
+  RunResult result;
+  memset (&result, 0, sizeof (result));
+  result.meanDelay = std::numeric_limits<double>::quiet_NaN (); //the sink counters carry no timestamps
+  result.meanJitter = std::numeric_limits<double>::quiet_NaN ();
+  uint32_t headerBytes = params.traffic == "bulk" ? 0 : 28; //IPv4 and UDP headers
+  std::vector<double> throughputs;
+  std::vector<uint32_t> flowBss;
+  for (uint32_t node = 0; node < g_traces.isStation.size (); ++node)
+    {
+      if (!g_traces.isStation[node])
+        {
+          continue;
+        }
+      uint64_t rxBytes = g_traces.rxBytes[node] + g_traces.rxPackets[node] * headerBytes;
+      double throughput = ThroughputOf (rxBytes, params);
+      result.txPackets += g_traces.txPackets[node];
+      result.rxPackets += g_traces.rxPackets[node];
+      throughputs.push_back (throughput);
+      flowBss.push_back (g_traces.bssOf[node]);
+
+      ResultRecord record;
+      record.Add ("node", node);
+      record.Add ("bss", g_traces.bssOf[node]);
+      record.Add ("txPackets", g_traces.txPackets[node]);
+      record.Add ("rxPackets", g_traces.rxPackets[node]);
+      record.Add ("rxBytes", rxBytes);
+      record.Add ("throughput", throughput);
+      flows.push_back (record);
+    }
+  SummarizeFlows (result, throughputs, flowBss, bssRecords);
+  return result;
+}
+
+void
+AddParams (ResultRecord &record, const ScenarioParams &params)
+{
+  record.Add ("rayleigh", params.rayleigh);
+  record.Add ("cara", params.cara);
+  record.Add ("seed", params.seed);
+  record.Add ("distance", params.distance);
+  record.Add ("nodeNum", params.nodeNum);
+  record.Add ("apNum", params.apNum);
+  record.AddText ("apLayout", params.apLayout);
+  record.Add ("apSpacing", params.apSpacing);
+  record.AddText ("channels", params.channels);
+  record.Add ("warmup", params.warmup);
+  record.AddText ("fading", params.fading);
+  record.Add ("coherenceTime", params.coherenceTime);
+  record.AddText ("manager", params.manager);
+  record.AddText ("managerAttributes", params.managerAttributes);
+  record.AddText ("traffic", params.traffic);
+  record.AddText ("dataRate", params.dataRate);
+  record.Add ("packetSize", params.packetSize);
+  record.AddText ("load", params.load);
+  record.AddText ("onTime", params.onTime);
+  record.AddText ("offTime", params.offTime);
+  record.AddText ("measure", params.measure);
+  record.AddText ("mobility", params.mobility);
+  record.Add ("speed", params.speed);
+  record.Add ("mobilityBounds", params.mobilityBounds);
+  record.AddText ("replication", params.replication);
+  record.Add ("rngSeed", params.rngSeed);
+  record.Add ("stopTime", params.stopTime);
+  record.AddText ("ssid", params.ssid);
+  record.AddText ("addressBase", params.addressBase);
+  record.Add ("port", params.port);
+  record.Add ("lossExponent", params.lossExponent);
+  record.AddText ("placement", params.placement);
+  record.AddText ("stationRho", params.stationRho);
+  record.AddText ("direction", params.direction);
+  record.AddText ("attributes", params.attributes);
+}
+
+ResultRecord
+MakeRecord (const ScenarioParams &params, const RunResult &result)
+{
+  ResultRecord record;
+  AddParams (record, params);
+  record.AddText ("throughputUnit", params.throughputUnit);
+  record.Add ("throughput", result.throughput);
+  record.Add ("txPackets", result.txPackets);
+  record.Add ("rxPackets", result.rxPackets);
+  record.Add ("meanDelay", result.meanDelay);
+  record.Add ("meanJitter", result.meanJitter);
+  record.Add ("flows", result.flows);
+  record.Add ("jainIndex", result.jainIndex);
+  record.Add ("minThroughput", result.minThroughput);
+  record.Add ("p10Throughput", result.p10Throughput);
+  record.Add ("medianThroughput", result.medianThroughput);
+  record.Add ("p90Throughput", result.p90Throughput);
+  record.Add ("maxThroughput", result.maxThroughput);
+  record.Add ("dataFrames", result.dataFrames);
+  record.Add ("rateChanges", result.rateChanges);
+  record.Add ("txDataFailed", result.txDataFailed);
+  record.Add ("txFinalDataFailed", result.txFinalDataFailed);
+  record.Add ("txRtsFailed", result.txRtsFailed);
+  record.Add ("phyRxDrop", result.phyRxDrop);
+  record.Add ("buildSeconds", result.buildSeconds);
+  record.Add ("topologySeconds", result.topologySeconds);
+  record.Add ("stackSeconds", result.stackSeconds);
+  record.Add ("runSeconds", result.runSeconds);
+  record.Add ("cpuSeconds", result.cpuSeconds);
+  record.Add ("outputSeconds", result.outputSeconds);
+  record.Add ("writeSeconds", result.writeSeconds);
+  record.Add ("events", result.events);
+  record.Add ("eventsPerSecond", result.eventsPerSecond);
+  //a run's own peak or nothing: a process-wide figure would belong to whichever run of the process was largest
+  record.Add ("peakRssKb", result.peakRssKb < 0 ? std::numeric_limits<double>::quiet_NaN () : (double)result.peakRssKb);
+  return record;
+}
+
+//name=value of every parameter that changes the records of a run, the identity of a run in the result
+//index and in the name of its frame trace
+std::string
+ParamsText (const ScenarioParams &params)
+{
+  ResultRecord record;
+  AddParams (record, params);
+  record.Add ("sampleInterval", params.sampleInterval);
+  record.Add ("sampleCapacity", params.sampleCapacity);
+  record.Add ("lossCache", params.lossCache);
+  record.AddText ("throughputUnit", params.throughputUnit);
+  std::ostringstream oss;
+  oss.precision (17);
+  for (size_t i = 0; i < record.names.size (); ++i)
+    {
+      oss << (i > 0 ? "," : "") << record.names[i] << '=';
+      if (record.isText[i])
+        {
+          oss << record.texts[i];
+        }
+      else
+        {
+          oss << record.numbers[i];
+        }
+    }
+  return oss.str ();
+}
+
+//FNV-1a hash of text as 16 hex digits
+std::string
+HashHex (const std::string &text)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < text.size (); ++i)
+    {
+      hash = (hash ^ (unsigned char)text[i]) * 1099511628211ULL;
+    }
+  char hex[17];
+  snprintf (hex, sizeof (hex), "%016llx", (unsigned long long)hash);
+  return hex;
+}
+
+//Full TypeId name of a station manager given as "Minstrel" or "ns3::MinstrelWifiManager"
+std::string
+ManagerTypeName (const std::string &manager)
+{
+  return manager.find ("::") != std::string::npos ? manager : "ns3::" + manager + "WifiManager";
+}
+
+//Configure the rate adaptation of params on wifi, passing its attributes to the manager factory
+void
+SetStationManager (WifiHelper &wifi, const ScenarioParams &params)
+{
+  std::vector<std::string> attributes = SplitList (params.managerAttributes, ',');
+  if (attributes.size () > 8)
+    {
+      NS_FATAL_ERROR ("at most 8 manager attributes are supported, got " << params.managerAttributes);
+    }
+  std::string names[8];
+  StringValue values[8];
+  for (size_t i = 0; i < attributes.size (); ++i)
+    {
+      std::string::size_type equals = attributes[i].find ('=');
+      if (equals == std::string::npos)
+        {
+          NS_FATAL_ERROR ("manager attribute " << attributes[i] << " is not Name=Value");
+        }
+      names[i] = attributes[i].substr (0, equals);
+      values[i] = StringValue (attributes[i].substr (equals + 1));
+    }
+  wifi.SetRemoteStationManager (ManagerTypeName (params.manager),
+                                names[0], values[0], names[1], values[1], names[2], values[2], names[3], values[3],
+                                names[4], values[4], names[5], values[5], names[6], values[6], names[7], values[7]);
+}
+
+//Topology of one run as made by BuildScenario and measured by MeasureScenario
+struct Scenario
+{
+  NodeContainer wifiStaNodes;
+  NodeContainer wifiApNode;
+  NetDeviceContainer staDevices;
+  NetDeviceContainer apDevices;
+  Ipv4InterfaceContainer staAddress;
+  Ipv4InterfaceContainer apAddress;
+  Ptr<YansWifiChannel> channel;
+  std::vector<uint32_t> stationBss; //BSS of every station
+  std::vector<uint32_t> bssChannel; //channel number of every BSS
+  double started; //wall time the build, or the reseed of a warmed-up scenario, started
+  double cpuStarted; //CPU time of the process at that point
+  bool rssReset; //whether the peak resident set size was reset at that point, see ResetPeakRss
+  double topologySeconds;
+  double stackSeconds;
+};
+
+//Give every random variable of a built scenario its stream from the layout of NodeStream. Called after
+//SetRandomRun, whenever the seed or run changes, as the streams only take them up when they are assigned.
+void
+AssignScenarioStreams (const Scenario &scenario)
+{
+  YansWifiChannelHelper channel;
+  NS_ABORT_MSG_IF (channel.AssignStreams (scenario.channel, 0) > channelStreams, "channel needs more streams");
+  WifiHelper wifi;
+  NetDeviceContainer devices = scenario.apDevices;
+  devices.Add (scenario.staDevices);
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      uint32_t node = devices.Get (i)->GetNode ()->GetId ();
+      NS_ABORT_MSG_IF (wifi.AssignStreams (NetDeviceContainer (devices.Get (i)), NodeStream (node, STREAM_DEVICE))
+                       > STREAM_STACK - STREAM_DEVICE, "wifi device needs more streams");
+    }
+  InternetStackHelper stack;
+  NodeContainer nodes = scenario.wifiApNode;
+  nodes.Add (scenario.wifiStaNodes);
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      uint32_t node = nodes.Get (i)->GetId ();
+      NS_ABORT_MSG_IF (stack.AssignStreams (NodeContainer (nodes.Get (i)), NodeStream (node, STREAM_STACK))
+                       > STREAM_PLACEMENT - STREAM_STACK, "internet stack needs more streams");
+      Ptr<MobilityModel> mobility = nodes.Get (i)->GetObject<MobilityModel> ();
+      mobility->AssignStreams (NodeStream (node, STREAM_MOBILITY));
+      PointerValue waypoints;
+      if (mobility->GetAttributeFailSafe ("PositionAllocator", waypoints))
+        {
+          waypoints.Get<PositionAllocator> ()->AssignStreams (NodeStream (node, STREAM_MOBILITY) + 4);
+        }
+    }
+}
+
+//Position of AP k out of apNum: a grid with ceil(sqrt(apNum)) columns, or the same rows shifted by
+//half a spacing on every other row and pulled together to form a hexagonal layout
+Vector
+ApPosition (int k, int apNum, const std::string &layout, double spacing)
+{
+  int columns = (int)std::ceil (std::sqrt ((double)apNum));
+  int row = k / columns;
+  int column = k % columns;
+  if (layout == "hex")
+    {
+      return Vector ((column + (row % 2) * 0.5) * spacing, row * spacing * std::sqrt (3.0) / 2.0, 0.0);
+    }
+  return Vector (column * spacing, row * spacing, 0.0);
+}
+
+//Put the stations of every BSS on the disc of params.stationRho around their AP, or params.distance metres east
+//of it for placement "distance", moving them back if they are placed already
+void
+PlaceStations (const ScenarioParams &params, const Scenario &scenario)
+{
+  int nodeNum = params.nodeNum;
+  std::string rho = params.stationRho;
+  if (params.placement == "distance")
+    {
+      std::ostringstream distance;
+      distance << "ns3::ConstantRandomVariable[Constant=" << params.distance << "]";
+      rho = distance.str ();
+    }
+// Mobility Helper for Stations (Random position over circumference of a 10m radius circle around their AP)
+  for (int k = 0; k < params.apNum; ++k)
+    {
+      Vector position = ApPosition (k, params.apNum, params.apLayout, params.apSpacing);
+      for (int i = k * nodeNum; i < (k + 1) * nodeNum; ++i)
+        {
+          Ptr<Node> station = scenario.wifiStaNodes.Get (i);
+          Ptr<RandomDiscPositionAllocator> disc = CreateObject<RandomDiscPositionAllocator> ();
+          disc->SetX (position.x);
+          disc->SetY (position.y);
+          disc->SetAttribute ("Rho", StringValue (rho));
+          if (params.placement == "distance")
+            {
+              disc->SetAttribute ("Theta", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+            }
+          disc->AssignStreams (NodeStream (station->GetId (), STREAM_PLACEMENT)); //the position of a station only depends on its own stream
+          MobilityHelper mobilitySta;
+          mobilitySta.SetPositionAllocator (disc);
+          SetStationMobility (mobilitySta, params, position); //constant position unless params.mobility says otherwise
+          mobilitySta.Install (station);
+          StartStationMobility (params, station, position);
+        }
+    }
+}
+
+//Announce the run about to be built, by the parameter the study sweeps
+void
+PrintRun (const ScenarioParams &params, const char *suffix)
+{
+  if (params.placement == "distance")
+    {
+      std::cout << "Distance:" << params.distance << ", Seed:" << params.seed << suffix << std::endl;
+    }
+  else
+    {
+      std::cout << "Number of Stations: " << params.nodeNum << ", Seed:" << params.seed << suffix << std::endl;
+    }
+}
+
+//The propagation loss model of type T on the chain of channel, 0 if it has none
+template <class T>
+Ptr<T>
+FindLossModel (Ptr<YansWifiChannel> channel)
+{
+  PointerValue first;
+  channel->GetAttribute ("PropagationLossModel", first);
+  for (Ptr<PropagationLossModel> model = first.Get<PropagationLossModel> (); model != 0; model = model->GetNext ())
+    {
+      Ptr<T> found = DynamicCast<T> (model);
+      if (found != 0)
+        {
+          return found;
+        }
+    }
+  return 0;
+}
+
+//Create the nodes, devices, mobility and addresses of one scenario, everything up to the traffic
+void
+BuildScenario (const ScenarioParams &params, Scenario &scenario)
+{
+  bool rayleigh = params.rayleigh;
+  int nodeNum = params.nodeNum;
+  int apNum = params.apNum;
+  std::vector<double> channelNumbers = ParseRange (params.channels);
+  if (apNum < 1 || channelNumbers.empty ())
+    {
+      NS_FATAL_ERROR ("need at least one AP and one channel, got apNum=" << apNum << " channels=" << params.channels);
+    }
+
+  PrintRun (params, "");
+  scenario.started = WallSeconds ();
+  scenario.cpuStarted = CpuSeconds ();
+  scenario.rssReset = ResetPeakRss ();
+  g_eventCounts.clear ();
+  SetRandomRun (params); //seed or run number should change between runs if running multiple simulations.
+  Ipv4AddressGenerator::Reset (); //addresses handed out by a previous run in this process would otherwise collide
+
+  NodeContainer wifiStaNodes; //create the AP Nodes and nodeNum Station nodes per AP, stations of BSS k are k*nodeNum..
+  wifiStaNodes.Create (nodeNum * apNum);
+  NodeContainer wifiApNode;
+  wifiApNode.Create(apNum);
+
+  YansWifiChannelHelper channel; //create helpers for the channel and phy layer and set propagation configuration here.
+  channel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  if (params.lossCache && params.mobility == "static") //moving stations would invalidate the cached links on every frame
+    {
+      channel.AddPropagationLoss ("ns3::CachedLogDistancePropagationLossModel",
+                                  "Exponent", DoubleValue (params.lossExponent)); //same loss, computed once per node pair
+    }
+  else
+    {
+      channel.AddPropagationLoss("ns3::LogDistancePropagationLossModel", "Exponent", DoubleValue(params.lossExponent)); //on the instance, the attribute default stays the user's
+    }
+  if(rayleigh && params.fading == "batch"){
+    channel.AddPropagationLoss("ns3::BatchRayleighPropagationLossModel"); //same Exp(1) power gains as nakagami with m=1, generated in batches per station-AP link
+  }else if(rayleigh && (params.fading == "block" || params.fading == "ar1")){
+    channel.AddPropagationLoss("ns3::CoherentRayleighPropagationLossModel",
+                               "CoherenceTime", DoubleValue(params.coherenceTime),
+                               "Autoregressive", BooleanValue(params.fading == "ar1")); //rayleigh fading correlated over time, updated only when a link is used
+  }else if(rayleigh){
+    channel.AddPropagationLoss("ns3::NakagamiPropagationLossModel",
+	                           "m0", DoubleValue(1.0), "m1", DoubleValue(1.0), "m2", DoubleValue(1.0)); //combining log and nakagami to have both distance and rayleigh fading (nakami with m0, m1 and m2 =1 is rayleigh)
+  }
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  scenario.channel = channel.Create ();
+  phy.SetChannel (scenario.channel);
+
+  WifiHelper wifi;  //create helper for the overall wifi setup and configure a station manager
+  wifi.SetStandard(ns3::WIFI_PHY_STANDARD_80211g);
+  SetStationManager (wifi, params); //Aarf or Cara by default, any manager with --manager
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default (); //create a mac helper and configure for station and AP and install
+
+  //one BSS per AP, all sharing the channel object so BSSs on the same channel number interfere
+  NetDeviceContainer staDevices;
+  NetDeviceContainer apDevices;
+  std::vector<NetDeviceContainer> bssDevices (apNum); //station devices of every BSS
+  std::vector<uint32_t> stationBss (wifiStaNodes.GetN ());
+  std::vector<uint32_t> bssChannel (apNum);
+  for (int k = 0; k < apNum; ++k)
+    {
+      bssChannel[k] = (uint32_t)channelNumbers[k % channelNumbers.size ()];
+      phy.Set ("ChannelNumber", UintegerValue (bssChannel[k]));
+
+      std::ostringstream ssidName;
+      ssidName << params.ssid;
+      if (apNum > 1)
+        {
+          ssidName << "-" << k;
+        }
+      Ssid ssid = Ssid (ssidName.str ());
+      NodeContainer bssStations;
+      for (int i = k * nodeNum; i < (k + 1) * nodeNum; ++i)
+        {
+          bssStations.Add (wifiStaNodes.Get (i));
+          stationBss[i] = k;
+        }
+      mac.SetType ("ns3::StaWifiMac",
+                   "Ssid", SsidValue (ssid),
+                   "ActiveProbing", BooleanValue (false));
+      bssDevices[k] = wifi.Install (phy, mac, bssStations);
+      staDevices.Add (bssDevices[k]);
+
+      mac.SetType ("ns3::ApWifiMac",
+                   "Ssid", SsidValue (ssid));
+      apDevices.Add (wifi.Install (phy, mac, wifiApNode.Get (k)));
+    }
+// Mobility Helper for the APs (Constant Position, AP 0 at (0,0) and the others at apSpacing on a grid or hex layout)
+  for (int k = 0; k < apNum; ++k)
+    {
+      Vector position = ApPosition (k, apNum, params.apLayout, params.apSpacing);
+      MobilityHelper mobilityAp;
+      mobilityAp.SetPositionAllocator ("ns3::RandomDiscPositionAllocator",
+                                      "X", DoubleValue (position.x),
+                                      "Y", DoubleValue (position.y),
+                                      "Theta", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"),
+                                      "Rho", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+      mobilityAp.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+      mobilityAp.Install (wifiApNode.Get (k));
+    }
+
+  scenario.wifiStaNodes = wifiStaNodes;
+  PlaceStations (params, scenario);
+
+  std::vector<uint32_t> peer (NodeList::GetNNodes ()); //the AP of every station, the node itself for the APs
+  for (uint32_t node = 0; node < peer.size (); ++node)
+    {
+      peer[node] = node;
+    }
+  for (uint32_t i = 0; i < wifiStaNodes.GetN (); ++i)
+    {
+      peer[wifiStaNodes.Get (i)->GetId ()] = wifiApNode.Get (stationBss[i])->GetId ();
+    }
+  Ptr<CoherentRayleighPropagationLossModel> coherent = FindLossModel<CoherentRayleighPropagationLossModel> (scenario.channel);
+  if (coherent != 0)
+    {
+      coherent->SetPeers (peer); //the links whose fading keeps state
+    }
+  Ptr<BatchRayleighPropagationLossModel> batch = FindLossModel<BatchRayleighPropagationLossModel> (scenario.channel);
+  if (batch != 0)
+    {
+      batch->SetPeers (peer); //the links whose gains are generated in batches
+    }
+  Ptr<CachedLogDistancePropagationLossModel> lossCache = FindLossModel<CachedLogDistancePropagationLossModel> (scenario.channel);
+  if (lossCache != 0)
+    {
+      lossCache->SetPeers (peer); //the links still cached above lossCacheNodes nodes
+    }
+//Debugging
+/*  Ptr<MobilityModel> mobModel = wifiApNode.Get(0)->GetObject<MobilityModel>();
+  Vector3D pos = mobModel->GetPosition();
+  NS_LOG_UNCOND("AP: Position(" << pos.x << ", "
+              << pos.y << ", " << pos.z << ");" << std::endl );
+  mobModel = wifiStaNodes.Get(0)->GetObject<MobilityModel>();
+  pos = mobModel->GetPosition();
+  NS_LOG_UNCOND("Station: Position(" << pos.x << ", "
+              << pos.y << ", " << pos.z << ");" << std::endl );
+*/
+
+  double topologyBuilt = WallSeconds ();
+  InternetStackHelper stack; //install the internet stack on both nodes
+  stack.Install (wifiApNode);
+  stack.Install (wifiStaNodes);
+
+  //every BSS gets its own subnet, the AP first and then its stations: consecutive /24s from addressBase, or
+  //larger blocks when a BSS has more stations than a /24 holds. Address i of staAddress is station i's.
+  uint32_t block = 256;
+  while (block < (uint32_t)nodeNum + 3) //the AP, the stations and the network and broadcast addresses
+    {
+      block *= 2;
+    }
+  uint32_t network = Ipv4Address (params.addressBase.c_str ()).Get () & ~(block - 1);
+  if ((uint64_t)network + (uint64_t)block * apNum > 0xffffffffULL)
+    {
+      NS_FATAL_ERROR ("addressBase " << params.addressBase << " has no room for " << apNum << " subnets of " << block << " addresses");
+    }
+  Ipv4AddressHelper address; //assign IP addresses to all nodes
+  Ipv4InterfaceContainer apAddress; //we need to keep AP addresses accessible as we need them later
+  Ipv4InterfaceContainer staAddress;
+  for (int k = 0; k < apNum; ++k)
+    {
+      address.SetBase (Ipv4Address (network + k * block), Ipv4Mask (~(block - 1)));
+      apAddress.Add (address.Assign (NetDeviceContainer (apDevices.Get (k))));
+      staAddress.Add (address.Assign (bssDevices[k]));
+    }
+
+  std::cout << "ApAdress: ";
+  apAddress.GetAddress(0).Print(std::cout);
+  std::cout << std::endl;
+
+  scenario.wifiApNode = wifiApNode;
+  scenario.staDevices = staDevices;
+  scenario.apDevices = apDevices;
+  scenario.staAddress = staAddress;
+  scenario.apAddress = apAddress;
+  scenario.stationBss = stationBss;
+  scenario.bssChannel = bssChannel;
+  AssignScenarioStreams (scenario);
+  scenario.topologySeconds = topologyBuilt - scenario.started;
+  scenario.stackSeconds = WallSeconds () - topologyBuilt;
+}
+
+//Have the rate manager of device treat peer as supporting every mode of its PHY, as association leaves it
+//between two 802.11g devices
+void
+SupportAllModes (Ptr<WifiNetDevice> device, Mac48Address peer)
+{
+  Ptr<WifiPhy> phy = device->GetPhy ();
+  for (uint32_t i = 0; i < phy->GetNModes (); ++i)
+    {
+      device->GetRemoteStationManager ()->AddSupportedMode (peer, phy->GetMode (i));
+    }
+}
+
+//Forget what the rate managers of all devices learned during the warm-up, so that every seed of a warmed-up
+//group starts rate adaptation afresh like a cold run. Reset also drops what association recorded in the
+//managers, so that is put back: the AP keeps its associated stations and every station-AP pair supports
+//all modes.
+void
+ResetRateManagers (const Scenario &scenario)
+{
+  for (uint32_t k = 0; k < scenario.apDevices.GetN (); ++k)
+    {
+      Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice> (scenario.apDevices.Get (k));
+      std::vector<Mac48Address> associated;
+      for (uint32_t i = 0; i < scenario.staDevices.GetN (); ++i)
+        {
+          Mac48Address station = Mac48Address::ConvertFrom (scenario.staDevices.Get (i)->GetAddress ());
+          if (scenario.stationBss[i] == k && ap->GetRemoteStationManager ()->IsAssociated (station))
+            {
+              associated.push_back (station);
+            }
+        }
+      ap->GetRemoteStationManager ()->Reset ();
+      for (size_t i = 0; i < associated.size (); ++i)
+        {
+          SupportAllModes (ap, associated[i]);
+          ap->GetRemoteStationManager ()->RecordGotAssocTxOk (associated[i]);
+        }
+    }
+  for (uint32_t i = 0; i < scenario.staDevices.GetN (); ++i)
+    {
+      Ptr<WifiNetDevice> station = DynamicCast<WifiNetDevice> (scenario.staDevices.Get (i));
+      station->GetRemoteStationManager ()->Reset ();
+      SupportAllModes (station, Mac48Address::ConvertFrom (scenario.apDevices.Get (scenario.stationBss[i])->GetAddress ()));
+    }
+}
+
+//Give a built and warmed-up scenario the random streams of params.seed: the devices, the channel and the
+//internet stacks draw from streams of the new seed, the stations get new positions and the rate managers
+//start afresh. Association, the BSS of every station and the rest of the warm-up state stay those of the
+//shared seed-1 build. The traffic is drawn later by MeasureScenario, whose streams are created after the
+//seed is set.
+void
+ReseedScenario (const ScenarioParams &params, Scenario &scenario)
+{
+  PrintRun (params, " (warmed up)");
+  scenario.started = WallSeconds ();
+  scenario.cpuStarted = CpuSeconds ();
+  scenario.rssReset = ResetPeakRss ();
+  scenario.topologySeconds = 0.0;
+  scenario.stackSeconds = 0.0;
+  g_eventCounts.clear ();
+  SetRandomRun (params);
+  PlaceStations (params, scenario);
+  Ptr<CachedLogDistancePropagationLossModel> lossCache = FindLossModel<CachedLogDistancePropagationLossModel> (scenario.channel);
+  if (lossCache != 0)
+    {
+      lossCache->Clear (); //the stations have new positions
+    }
+  ResetRateManagers (scenario);
+  AssignScenarioStreams (scenario);
+}
+
+//Install the traffic of all stations in bulk: one sender Install over the downlink senders on the APs
+//and one per BSS over its uplink stations, after which every sender gets its own remote, offered load,
+//packet size and start time. One packet sink goes on every AP that has uplink stations and one sink
+//install covers all receiving stations. bss[i] is the BSS of station i, downlink[i] says whether it
+//receives from its AP, start[i], rate[i] and size[i] are the start time, load and packet size of its sender.
+void
+InstallTraffic (const ScenarioParams &params, NodeContainer stations, NodeContainer aps,
+                Ipv4InterfaceContainer staAddress, Ipv4InterfaceContainer apAddress, uint16_t port,
+                const std::vector<uint32_t> &bss, const std::vector<bool> &downlink,
+                const std::vector<double> &start, const std::vector<double> &rate,
+                const std::vector<uint32_t> &size)
+{
+  std::vector<NodeContainer> uplinkStations (aps.GetN ());
+  std::vector<std::vector<uint32_t> > uplinkIds (aps.GetN ());
+  NodeContainer downlinkSenders;
+  NodeContainer downlinkStations;
+  std::vector<uint32_t> downlinkIds;
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      if (downlink[i])
+        {
+          downlinkSenders.Add (aps.Get (bss[i]));
+          downlinkStations.Add (stations.Get (i));
+          downlinkIds.push_back (i);
+        }
+      else
+        {
+          uplinkStations[bss[i]].Add (stations.Get (i));
+          uplinkIds[bss[i]].push_back (i);
+        }
+    }
+  ApplicationContainer apps = InstallSenders (params, downlinkSenders);
+  for (uint32_t j = 0; j < downlinkIds.size (); ++j)
+    {
+      uint32_t i = downlinkIds[j];
+      ConfigureSender (apps.Get (j), params, stations.Get (i)->GetId (), InetSocketAddress (staAddress.GetAddress (i), port),
+                       rate[i], size[i], start[i]);
+    }
+  for (uint32_t k = 0; k < aps.GetN (); ++k)
+    {
+      if (uplinkStations[k].GetN () == 0)
+        {
+          continue;
+        }
+      ApplicationContainer uplinkApps = InstallSenders (params, uplinkStations[k]);
+      for (uint32_t j = 0; j < uplinkApps.GetN (); ++j)
+        {
+          uint32_t i = uplinkIds[k][j];
+          ConfigureSender (uplinkApps.Get (j), params, stations.Get (i)->GetId (), InetSocketAddress (apAddress.GetAddress (k), port),
+                           rate[i], size[i], start[i]);
+        }
+      apps.Add (uplinkApps);
+    }
+  apps.Stop (Seconds (params.stopTime));
+
+  PacketSinkHelper sink (TrafficSocketFactory (params), InetSocketAddress (Ipv4Address::GetAny (), port));
+  for (uint32_t k = 0; k < aps.GetN (); ++k)
+    {
+      if (uplinkStations[k].GetN () > 0)
+        {
+          sink.Install (aps.Get (k));
+        }
+    }
+  sink.Install (downlinkStations);
+}
+
+//Draw the traffic of the seed, run the measured stopTime seconds and tear down. All times are relative to the current
+//simulation time, so this runs the same on a fresh scenario and on one that has been warmed up.
+RunResult
+MeasureScenario (const ScenarioParams &params, Scenario &scenario, std::vector<std::vector<ResultRecord> > &details)
+{
+  NodeContainer wifiStaNodes = scenario.wifiStaNodes;
+  NodeContainer wifiApNode = scenario.wifiApNode;
+  Ipv4InterfaceContainer staAddress = scenario.staAddress;
+  Ipv4InterfaceContainer apAddress = scenario.apAddress;
+
+  std::vector<bool> downlink (wifiStaNodes.GetN ());
+  std::vector<double> start (wifiStaNodes.GetN ());
+  for (uint32_t staId = 0; staId < wifiStaNodes.GetN (); ++staId)
+  {
+    //Randomly select who to tx and who to rx between AP and Station, from streams of the station's own
+    uint32_t node = wifiStaNodes.Get (staId)->GetId ();
+    downlink[staId] = params.direction == "random" ? StationDraw (node, TRAFFIC_DIRECTION, 0, 1.0) > 0.5 //Ap Tx , Station Rx
+                                                   : params.direction == "downlink";
+    start[staId] = StationDraw (node, TRAFFIC_START, 0, 0.1);
+  }
+  std::vector<double> rate;
+  std::vector<uint32_t> size;
+  DrawTraffic (params, wifiStaNodes, rate, size);
+  InstallTraffic (params, wifiStaNodes, wifiApNode, staAddress, apAddress, params.port, scenario.stationBss, downlink,
+                  start, rate, size);
+
+  Simulator::Stop (Seconds (params.stopTime)); //define stop time of simulator
+
+  Ptr<FlowMonitor> flowmon; //create an install a flow monitor to monitor all transmissions around the network
+  FlowMonitorHelper flowmonHelper;
+  if (params.measure == "flowmon")
+    {
+      flowmon = flowmonHelper.InstallAll();
+    }
+
+  StartFrameTrace (params);
+  ConnectTraces (wifiStaNodes, wifiApNode, scenario.staDevices, staAddress, apAddress, scenario.stationBss, scenario.bssChannel);
+  if (params.sampleInterval > 0.0)
+    {
+      StartSampler (params.sampleInterval, params.sampleCapacity, wifiStaNodes.GetN (), params.stopTime);
+    }
+
+  double built = WallSeconds ();
+  Simulator::Run (); //run the simulation and destroy it once done
+  double ran = WallSeconds ();
+  StopFrameTrace ();
+  if (params.sampleInterval > 0.0)
+    {
+      FlushSamples (params.sampleInterval, details[DETAIL_SAMPLES]);
+    }
+  Simulator::Destroy ();
+
+  RunResult result = params.measure == "flowmon" ? FlowOutput(params, flowmon, flowmonHelper, details[DETAIL_FLOWS], details[DETAIL_BSS])
+                                                 : ProbeOutput (params, details[DETAIL_FLOWS], details[DETAIL_BSS]);
+  FlushStationCounters (result, params.verbose, details[DETAIL_STATIONS]);
+  result.buildSeconds = built - scenario.started;
+  result.topologySeconds = scenario.topologySeconds;
+  result.stackSeconds = scenario.stackSeconds;
+  result.runSeconds = ran - built;
+  result.cpuSeconds = CpuSeconds () - scenario.cpuStarted;
+  result.outputSeconds = WallSeconds () - ran;
+  FlushEventCounts (result, details[DETAIL_EVENTS]);
+  result.peakRssKb = scenario.rssReset ? PeakRssKb () : -1; //without the reset it is some earlier run's peak
+  return result;
+}
+
+//Build, run and tear down one scenario, returns the measurements collected by FlowOutput
+RunResult
+RunScenario (const ScenarioParams &params, std::vector<std::vector<ResultRecord> > &details)
+{
+  Scenario scenario;
+  BuildScenario (params, scenario);
+  return MeasureScenario (params, scenario, details);
+}
+
+//Relative cost of a sweep point, contention work grows roughly with the square of the station count
+double
+EstimateCost (const ScenarioParams &params)
+{
+  double stations = (double)params.nodeNum * params.apNum;
+  double cost = stations * stations;
+  if (params.rayleigh)
+    {
+      cost *= 1.5;
+    }
+  return cost;
+}
+
+//Orders job indices so the most expensive points are handed out first
+struct CostOrder
+{
+  const std::vector<double> *costs;
+  bool operator() (size_t a, size_t b) const
+  {
+    return (*costs)[a] > (*costs)[b];
+  }
+};
+
+//Two-sided 95% quantile of Student's t distribution with df degrees of freedom
+double
+StudentT95 (size_t df)
+{
+  static const double quantiles[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+  if (df == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return df <= 30 ? quantiles[df - 1] : 1.960;
+}
+
+//Streaming mean, variance, min and max of one metric by Welford's update, constant memory however many runs.
+//NaN marks a value that was not measured and is left out; without any value the statistics are NaN.
+class RunningStats
+{
+public:
+  RunningStats ()
+    : m_n (0),
+      m_mean (0.0),
+      m_m2 (0.0),
+      m_min (0.0),
+      m_max (0.0)
+  {
+  }
+  void Add (double value)
+  {
+    if (value != value)
+      {
+        return;
+      }
+    ++m_n;
+    double delta = value - m_mean;
+    m_mean += delta / m_n;
+    m_m2 += delta * (value - m_mean);
+    m_min = m_n == 1 ? value : std::min (m_min, value);
+    m_max = m_n == 1 ? value : std::max (m_max, value);
+  }
+  uint64_t GetN (void) const
+  {
+    return m_n;
+  }
+  double GetMean (void) const
+  {
+    return m_n > 0 ? m_mean : std::numeric_limits<double>::quiet_NaN ();
+  }
+  double GetVariance (void) const
+  {
+    return m_n > 1 ? m_m2 / (m_n - 1) : (m_n > 0 ? 0.0 : std::numeric_limits<double>::quiet_NaN ());
+  }
+  double GetMin (void) const
+  {
+    return m_n > 0 ? m_min : std::numeric_limits<double>::quiet_NaN ();
+  }
+  double GetMax (void) const
+  {
+    return m_n > 0 ? m_max : std::numeric_limits<double>::quiet_NaN ();
+  }
+  //Half width of the 95% confidence interval of the mean, infinite below two runs
+  double GetHalfWidth (void) const
+  {
+    if (m_n < 2)
+      {
+        return std::numeric_limits<double>::infinity ();
+      }
+    return StudentT95 (m_n - 1) * std::sqrt (GetVariance () / m_n);
+  }
+
+private:
+  uint64_t m_n;
+  double m_mean;
+  double m_m2; //sum of squared deviations from the running mean
+  double m_min;
+  double m_max;
+};
+
+const size_t noBaseline = (size_t)-1; //point of a SweepSummary not paired with a baseline
+
+//Running statistics of every point of a sweep, fed with each record as it is written. After every batch
+//of written records the summary table (one row per point) and the plot table (one row per x value, with
+//the mean throughput and its CI half width of every series as columns) are rewritten, so a sweep that is
+//still running, or was killed, always has current tables without going over the raw records again.
+//A point paired with a baseline point also collects the per-seed throughput differences to the baseline,
+//written to the paired table with their CI next to the CI the two points would have unpaired.
+class SweepSummary
+{
+public:
+  SweepSummary (const ResultWriter &summaryWriter, const ResultWriter &plotWriter,
+                const ResultWriter &pairedWriter, const std::string &xName)
+    : m_summaryWriter (summaryWriter),
+      m_plotWriter (plotWriter),
+      m_pairedWriter (pairedWriter),
+      m_xName (xName),
+      m_paired (false)
+  {
+  }
+  //Register a point, its index is the one SetJobPoints refers to; series names its curve in the plot table
+  size_t AddPoint (const ScenarioParams &params, const std::string &series, double x)
+  {
+    Point point;
+    point.params = params;
+    point.series = series;
+    point.x = x;
+    point.baseline = noBaseline;
+    m_points.push_back (point);
+    return m_points.size () - 1;
+  }
+  //Compare point with baseline seed by seed; both must run the same seeds
+  void Pair (size_t point, size_t baseline)
+  {
+    m_points[point].baseline = baseline;
+    m_paired = true;
+  }
+  //Point of every job of the next RunJobs call
+  void SetJobPoints (const std::vector<size_t> &jobPoint)
+  {
+    m_jobPoint = jobPoint;
+  }
+  void Add (size_t job, int seed, const RunResult &result)
+  {
+    if (result.throughput != result.throughput) //failed runs come back as NaN
+      {
+        return;
+      }
+    size_t p = m_jobPoint[job];
+    Point &point = m_points[p];
+    point.throughput.Add (result.throughput);
+    point.jainIndex.Add (result.jainIndex);
+    point.medianThroughput.Add (result.medianThroughput);
+    point.meanDelay.Add (result.meanDelay);
+    point.cpuSeconds.Add (result.cpuSeconds);
+    if (!m_paired)
+      {
+        return;
+      }
+    //whichever of a pair finishes a seed second adds the difference
+    point.bySeed[seed] = result.throughput;
+    for (size_t q = 0; q < m_points.size (); ++q)
+      {
+        size_t baseline = q == p ? point.baseline : (m_points[q].baseline == p ? p : noBaseline);
+        if (baseline == noBaseline)
+          {
+            continue;
+          }
+        const std::map<int, double> &compared = m_points[q].bySeed;
+        const std::map<int, double> &base = m_points[baseline].bySeed;
+        std::map<int, double>::const_iterator a = compared.find (seed);
+        std::map<int, double>::const_iterator b = base.find (seed);
+        if (a != compared.end () && b != base.end ())
+          {
+            m_points[q].difference.Add (a->second - b->second);
+          }
+      }
+  }
+  const RunningStats &GetThroughput (size_t point) const
+  {
+    return m_points[point].throughput;
+  }
+  //Throughput of point minus that of its baseline, over the seeds both have run
+  const RunningStats &GetDifference (size_t point) const
+  {
+    return m_points[point].difference;
+  }
+  void Write (void) const
+  {
+    EncodedRecords summary;
+    std::vector<double> xs;
+    std::vector<std::string> series;
+    for (size_t p = 0; p < m_points.size (); ++p)
+      {
+        const Point &point = m_points[p];
+        ResultRecord record;
+        AddParams (record, point.params);
+        record.AddText ("series", point.series);
+        record.Add ("runs", point.throughput.GetN ());
+        AddStats (record, "throughput", point.throughput);
+        AddStats (record, "jainIndex", point.jainIndex);
+        AddStats (record, "medianThroughput", point.medianThroughput);
+        AddStats (record, "meanDelay", point.meanDelay);
+        AddStats (record, "cpuSeconds", point.cpuSeconds);
+        m_summaryWriter.Encode (record, summary);
+        if (std::find (xs.begin (), xs.end (), point.x) == xs.end ())
+          {
+            xs.push_back (point.x);
+          }
+        if (std::find (series.begin (), series.end (), point.series) == series.end ())
+          {
+            series.push_back (point.series);
+          }
+      }
+    m_summaryWriter.Replace (summary);
+
+    std::vector<const Point *> cells (xs.size () * series.size (), 0);
+    for (size_t p = 0; p < m_points.size (); ++p)
+      {
+        size_t x = std::find (xs.begin (), xs.end (), m_points[p].x) - xs.begin ();
+        size_t s = std::find (series.begin (), series.end (), m_points[p].series) - series.begin ();
+        cells[x * series.size () + s] = &m_points[p];
+      }
+    EncodedRecords plot;
+    for (size_t x = 0; x < xs.size (); ++x)
+      {
+        ResultRecord record;
+        record.Add (m_xName, xs[x]);
+        for (size_t s = 0; s < series.size (); ++s)
+          {
+            const Point *cell = cells[x * series.size () + s];
+            bool measured = cell != 0 && cell->throughput.GetN () > 0;
+            double nan = std::numeric_limits<double>::quiet_NaN ();
+            record.Add (series[s], measured ? cell->throughput.GetMean () : nan);
+            //no error bar below two runs
+            record.Add (series[s] + "Ci", measured && cell->throughput.GetN () > 1 ? cell->throughput.GetHalfWidth () : 0.0);
+          }
+        m_plotWriter.Encode (record, plot);
+      }
+    m_plotWriter.Replace (plot);
+
+    if (!m_paired)
+      {
+        return;
+      }
+    EncodedRecords paired;
+    for (size_t p = 0; p < m_points.size (); ++p)
+      {
+        const Point &point = m_points[p];
+        if (point.baseline == noBaseline)
+          {
+            continue;
+          }
+        const Point &baseline = m_points[point.baseline];
+        ResultRecord record;
+        AddParams (record, point.params);
+        record.AddText ("series", point.series);
+        record.AddText ("baseline", baseline.series);
+        record.Add ("pairs", point.difference.GetN ());
+        AddStats (record, "difference", point.difference);
+        record.Add ("relativeDifference", baseline.throughput.GetMean () != 0.0
+                    ? point.difference.GetMean () / baseline.throughput.GetMean () : 0.0);
+        //what the CI of the difference would be from the same runs as two independent samples
+        uint64_t n1 = point.throughput.GetN ();
+        uint64_t n2 = baseline.throughput.GetN ();
+        double unpaired = n1 > 1 && n2 > 1
+          ? StudentT95 (n1 + n2 - 2) * std::sqrt (point.throughput.GetVariance () / n1 + baseline.throughput.GetVariance () / n2)
+          : std::numeric_limits<double>::infinity ();
+        record.Add ("unpairedCi", unpaired);
+        record.Add ("ciReduction", point.difference.GetN () > 1 && point.difference.GetHalfWidth () > 0.0 ? unpaired / point.difference.GetHalfWidth () : 0.0);
+        m_pairedWriter.Encode (record, paired);
+      }
+    m_pairedWriter.Replace (paired);
+  }
+
+private:
+  struct Point
+  {
+    ScenarioParams params; //params.seed is the first seed of the point
+    std::string series;
+    double x;
+    RunningStats throughput;
+    RunningStats jainIndex;
+    RunningStats medianThroughput;
+    RunningStats meanDelay;
+    RunningStats cpuSeconds;
+    size_t baseline; //point compared against, noBaseline if none
+    std::map<int, double> bySeed; //throughput of every seed, kept only when points are paired
+    RunningStats difference; //throughput minus that of the baseline, per seed both have run
+  };
+
+  static void AddStats (ResultRecord &record, const std::string &name, const RunningStats &stats)
+  {
+    record.Add (name + "Mean", stats.GetMean ());
+    record.Add (name + "Sd", std::sqrt (stats.GetVariance ()));
+    record.Add (name + "Min", stats.GetMin ());
+    record.Add (name + "Max", stats.GetMax ());
+    record.Add (name + "Ci", stats.GetHalfWidth ());
+  }
+
+  ResultWriter m_summaryWriter;
+  ResultWriter m_plotWriter;
+  ResultWriter m_pairedWriter;
+  std::string m_xName;
+  bool m_paired; //whether any point has a baseline
+  std::vector<Point> m_points;
+  std::vector<size_t> m_jobPoint;
+};
+
+//Persistent index of finished runs next to the result file. The key is a hash of the build identity
+//(--buildId, which the scripts take from a hash of template.cc), of the column layout of the result
+//records and of every parameter of a run, seed included, the value its RunResult as the hex of its bytes,
+//which no longer decodes once RunResult changes. Any change to the program thus starts a new set of keys,
+//while rerunning the same build finds its runs. A restarted or extended sweep looks its jobs up here and
+//only runs the missing ones. An empty file name or build identity disables it.
+class ResultIndex
+{
+public:
+  ResultIndex (const std::string &fileName, const std::string &buildId)
+    : m_writer (fileName, false),
+      m_buildId (buildId),
+      m_enabled (!fileName.empty () && !buildId.empty ())
+  {
+    if (!m_enabled)
+      {
+        return;
+      }
+    std::ifstream in (fileName.c_str ());
+    std::string line;
+    std::getline (in, line); //header
+    while (std::getline (in, line))
+      {
+        std::string::size_type comma = line.find (',');
+        RunResult result;
+        if (comma != std::string::npos && Decode (line.substr (comma + 1), result)) //skips a line cut off by a crash
+          {
+            m_results[line.substr (0, comma)] = result;
+          }
+      }
+  }
+  bool Find (const ScenarioParams &params, RunResult &result) const
+  {
+    std::map<std::string, RunResult>::const_iterator it = m_results.find (Key (params));
+    if (!m_enabled || it == m_results.end ())
+      {
+        return false;
+      }
+    result = it->second;
+    return true;
+  }
+  void Record (const ScenarioParams &params, const RunResult &result)
+  {
+    if (!m_enabled)
+      {
+        return;
+      }
+    ResultRecord record;
+    record.AddText ("key", Key (params));
+    record.AddText ("result", Encode (result));
+    m_writer.Write (record);
+    m_results[Key (params)] = result;
+  }
+
+private:
+  //FNV-1a over the build identity, the result columns and name=value of every parameter that changes the records of a run
+  std::string Key (const ScenarioParams &params) const
+  {
+    std::ostringstream oss;
+    oss << m_buildId;
+    ResultRecord columns = MakeRecord (params, RunResult ());
+    for (size_t i = 0; i < columns.names.size (); ++i)
+      {
+        oss << ',' << columns.names[i];
+      }
+    return HashHex (oss.str () + ',' + ParamsText (params));
+  }
+  static std::string Encode (const RunResult &result)
+  {
+    static const char digits[] = "0123456789abcdef";
+    const unsigned char *bytes = (const unsigned char *)&result;
+    std::string hex;
+    for (size_t i = 0; i < sizeof (result); ++i)
+      {
+        hex += digits[bytes[i] >> 4];
+        hex += digits[bytes[i] & 15];
+      }
+    return hex;
+  }
+  static bool Decode (const std::string &hex, RunResult &result)
+  {
+    if (hex.size () != 2 * sizeof (result) || hex.find_first_not_of ("0123456789abcdef") != std::string::npos)
+      {
+        return false;
+      }
+    unsigned char *bytes = (unsigned char *)&result;
+    for (size_t i = 0; i < sizeof (result); ++i)
+      {
+        bytes[i] = (unsigned char)strtoul (hex.substr (2 * i, 2).c_str (), 0, 16);
+      }
+    return true;
+  }
+
+  ResultWriter m_writer;
+  std::string m_buildId;
+  bool m_enabled;
+  std::map<std::string, RunResult> m_results;
+};
+
+//A forked worker process evaluating the jobs first..last-1 and the pipe their results come back on
+struct Worker
+{
+  pid_t pid;
+  int fd;
+  size_t first;
+  size_t last;
+  std::string output;
+};
+
+//Hand the finished prefix of the job list to the writers, so records always come out in job order,
+//to summary, when given, whose tables are rewritten once per call that wrote anything, and every
+//successful run to index, when given, once its records are out. Failed runs (NaN throughput, see
+//UnpackGroup) write nothing: a resumed sweep runs them again and only then are they recorded.
+void
+WriteCompleted (const std::vector<ScenarioParams> &jobs, const std::vector<RunResult> &results,
+                std::vector<std::vector<EncodedRecords> > &details, const std::vector<bool> &done,
+                size_t &written, const ResultWriter &writer, const std::vector<ResultWriter> &detailWriters,
+                SweepSummary *summary, ResultIndex *index)
+{
+  size_t first = written;
+  while (written < jobs.size () && done[written])
+    {
+      double started = WallSeconds ();
+      for (size_t kind = 0; kind < details[written].size () && kind < detailWriters.size (); ++kind)
+        {
+          detailWriters[kind].Append (details[written][kind]);
+        }
+      details[written].clear ();
+      RunResult result = results[written];
+      result.writeSeconds += WallSeconds () - started;
+      if (result.throughput == result.throughput) //failed runs come back as NaN
+        {
+          writer.Write (MakeRecord (jobs[written], result));
+          if (summary != 0)
+            {
+              summary->Add (written, jobs[written].seed, result);
+            }
+          if (index != 0)
+            {
+              index->Record (jobs[written], result);
+            }
+        }
+      ++written;
+    }
+  if (summary != 0 && written > first)
+    {
+      summary->Write ();
+    }
+}
+
+//Encode the detail records of one run, each prefixed with the parameters of the run
+void
+EncodeDetails (const ScenarioParams &params, const std::vector<std::vector<ResultRecord> > &details,
+               const std::vector<ResultWriter> &detailWriters, std::vector<EncodedRecords> &encoded)
+{
+  encoded.assign (detailWriters.size (), EncodedRecords ());
+  for (size_t kind = 0; kind < detailWriters.size (); ++kind)
+    {
+      for (size_t i = 0; i < details[kind].size (); ++i)
+        {
+          ResultRecord record;
+          AddParams (record, params);
+          record.Append (details[kind][i]);
+          detailWriters[kind].Encode (record, encoded[kind]);
+        }
+    }
+}
+
+//Run one job and encode its detail records, prefixed with the job parameters, for the side files
+RunResult
+RunJob (const ScenarioParams &params, const std::vector<ResultWriter> &detailWriters,
+        std::vector<EncodedRecords> &encoded)
+{
+  std::vector<std::vector<ResultRecord> > details (DETAIL_KINDS);
+  RunResult result = RunScenario (params, details);
+  double encoding = WallSeconds ();
+  EncodeDetails (params, details, detailWriters, encoded);
+  result.writeSeconds = WallSeconds () - encoding;
+  return result;
+}
+
+
+void
+AppendBlock (std::string &out, const std::string &block)
+{
+  uint32_t length = block.size ();
+  out.append ((const char *)&length, sizeof (length));
+  out.append (block);
+}
+
+bool
+ReadBlock (const std::string &in, size_t &pos, std::string &block)
+{
+  uint32_t length = 0;
+  if (pos + sizeof (length) > in.size ())
+    {
+      return false;
+    }
+  memcpy (&length, in.data () + pos, sizeof (length));
+  pos += sizeof (length);
+  if (pos + length > in.size ())
+    {
+      return false;
+    }
+  block.assign (in, pos, length);
+  pos += length;
+  return true;
+}
+
+//What a worker sends back: the RunResult bytes followed by header and data of every detail kind
+std::string
+PackJobOutput (const RunResult &result, const std::vector<EncodedRecords> &encoded)
+{
+  std::string out;
+  AppendBlock (out, std::string ((const char *)&result, sizeof (result)));
+  for (size_t kind = 0; kind < encoded.size (); ++kind)
+    {
+      AppendBlock (out, encoded[kind].header);
+      AppendBlock (out, encoded[kind].data);
+    }
+  return out;
+}
+
+bool
+UnpackJobOutput (const std::string &in, size_t kinds, RunResult &result, std::vector<EncodedRecords> &encoded)
+{
+  size_t pos = 0;
+  std::string block;
+  if (!ReadBlock (in, pos, block) || block.size () != sizeof (result))
+    {
+      return false;
+    }
+  memcpy (&result, block.data (), sizeof (result));
+  encoded.assign (kinds, EncodedRecords ());
+  for (size_t kind = 0; kind < kinds; ++kind)
+    {
+      if (!ReadBlock (in, pos, encoded[kind].header) || !ReadBlock (in, pos, encoded[kind].data))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+//Whether two jobs only differ in their seed and so can share one warmed-up scenario
+bool
+SameScenario (const ScenarioParams &a, const ScenarioParams &b)
+{
+  return a.rayleigh == b.rayleigh && a.cara == b.cara && a.distance == b.distance && a.nodeNum == b.nodeNum
+         && a.apNum == b.apNum && a.apLayout == b.apLayout && a.apSpacing == b.apSpacing && a.channels == b.channels
+         && a.sampleInterval == b.sampleInterval && a.sampleCapacity == b.sampleCapacity && a.warmup == b.warmup
+         && a.lossCache == b.lossCache && a.fading == b.fading && a.coherenceTime == b.coherenceTime
+         && a.manager == b.manager && a.managerAttributes == b.managerAttributes && a.traffic == b.traffic
+         && a.dataRate == b.dataRate && a.packetSize == b.packetSize && a.load == b.load && a.onTime == b.onTime
+         && a.offTime == b.offTime && a.measure == b.measure && a.mobility == b.mobility && a.speed == b.speed
+         && a.mobilityBounds == b.mobilityBounds && a.replication == b.replication && a.rngSeed == b.rngSeed
+         && a.stopTime == b.stopTime && a.ssid == b.ssid && a.addressBase == b.addressBase && a.port == b.port
+         && a.lossExponent == b.lossExponent && a.placement == b.placement && a.stationRho == b.stationRho
+         && a.direction == b.direction && a.throughputUnit == b.throughputUnit && a.attributes == b.attributes;
+}
+
+//Read fd until end of file
+std::string
+ReadAll (int fd)
+{
+  std::string out;
+  char buffer[4096];
+  for (;;)
+    {
+      ssize_t n = read (fd, buffer, sizeof (buffer));
+      if (n > 0)
+        {
+          out.append (buffer, n);
+        }
+      else if (n == 0 || errno != EINTR)
+        {
+          return out;
+        }
+    }
+}
+
+//Build the scenario shared by the jobs first..last-1, which only differ in their seed, and run its
+//association warm-up once. Every seed then runs in a child forked from the warmed-up process, which
+//reseeds the streams, installs the traffic and simulates only the measured window. The packed output
+//of each job is appended to out as one block, an empty block for a job whose child failed.
+void
+RunWarmGroup (const std::vector<ScenarioParams> &jobs, size_t first, size_t last,
+              const std::vector<ResultWriter> &detailWriters, std::string &out)
+{
+  ScenarioParams warm = jobs[first];
+  warm.seed = 1; //the shared build must not depend on which seeds happen to share it
+  Scenario scenario;
+  BuildScenario (warm, scenario);
+  Simulator::Stop (Seconds (warm.warmup));
+  Simulator::Run ();
+
+  for (size_t job = first; job < last; ++job)
+    {
+      int fds[2];
+      if (pipe (fds) != 0)
+        {
+          NS_FATAL_ERROR ("pipe() failed: " << strerror (errno));
+        }
+      std::cout.flush ();
+      pid_t pid = fork ();
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("fork() failed: " << strerror (errno));
+        }
+      if (pid == 0)
+        {
+          close (fds[0]);
+          std::vector<std::vector<ResultRecord> > details (DETAIL_KINDS);
+          ReseedScenario (jobs[job], scenario);
+          RunResult result = MeasureScenario (jobs[job], scenario, details);
+          double encoding = WallSeconds ();
+          std::vector<EncodedRecords> encoded;
+          EncodeDetails (jobs[job], details, detailWriters, encoded);
+          result.writeSeconds = WallSeconds () - encoding;
+          WriteAll (fds[1], PackJobOutput (result, encoded));
+          close (fds[1]);
+          std::cout.flush ();
+          _exit (0);
+        }
+      close (fds[1]);
+      std::string output = ReadAll (fds[0]);
+      close (fds[0]);
+      int status = 0;
+      waitpid (pid, &status, 0);
+      AppendBlock (out, WIFEXITED (status) && WEXITSTATUS (status) == 0 ? output : std::string ());
+    }
+  Simulator::Destroy ();
+}
+
+//Evaluate the jobs first..last-1 as one unit of work: a warmed-up group when warmup is set, otherwise
+//the single job first. Returns one block of packed output per job.
+std::string
+RunGroup (const std::vector<ScenarioParams> &jobs, size_t first, size_t last,
+          const std::vector<ResultWriter> &detailWriters)
+{
+  std::string out;
+  if (jobs[first].warmup > 0.0)
+    {
+      RunWarmGroup (jobs, first, last, detailWriters, out);
+      return out;
+    }
+  std::vector<EncodedRecords> encoded;
+  RunResult result = RunJob (jobs[first], detailWriters, encoded);
+  AppendBlock (out, PackJobOutput (result, encoded));
+  return out;
+}
+
+//Unpack the output of RunGroup into results and details, marking jobs without valid output as failed
+void
+UnpackGroup (const std::string &out, bool ok, size_t first, size_t last, size_t kinds,
+             std::vector<RunResult> &results, std::vector<std::vector<EncodedRecords> > &details)
+{
+  size_t pos = 0;
+  for (size_t job = first; job < last; ++job)
+    {
+      std::string block;
+      if (!ok || !ReadBlock (out, pos, block) || !UnpackJobOutput (block, kinds, results[job], details[job]))
+        {
+          std::cerr << "Sweep point " << job << " failed" << std::endl;
+          memset (&results[job], 0, sizeof (results[job]));
+          results[job].throughput = std::numeric_limits<double>::quiet_NaN ();
+          details[job].clear ();
+        }
+    }
+}
+
+//Remove the records of jobs from the result files before they run, so a run that is run again (not found
+//in the result index, say after it failed or the index was deleted) replaces its earlier records. This
+//makes a pass over every result and detail file, so it is called once per sweep or single run, for all
+//the jobs it may run, before any of them.
+void
+DropRuns (const std::vector<ScenarioParams> &jobs, const ResultWriter &writer, const std::vector<ResultWriter> &detailWriters)
+{
+  std::vector<ResultRecord> keys (jobs.size ());
+  for (size_t j = 0; j < jobs.size (); ++j)
+    {
+      AddParams (keys[j], jobs[j]); //the leading columns of the run's result and detail records
+    }
+  writer.Drop (keys);
+  for (size_t kind = 0; kind < detailWriters.size (); ++kind)
+    {
+      detailWriters[kind].Drop (keys);
+    }
+}
+
+//Evaluate every job, write its records in job order and return the results. Earlier records of the
+//jobs must have been dropped from the result files, see DropRuns.
+//With workers == 0 the jobs run one after another in this process. Otherwise every job runs in its
+//own child forked from this (still pristine) process, at most `workers` at a time, pulled from a queue
+//sorted by EstimateCost. Each child starts from the same state, so the results do not depend on the
+//number of workers or on which worker picked up which job.
+//With a warmup, consecutive jobs that only differ in their seed form one group that is built and
+//warmed up once by RunWarmGroup; groups take the place of single jobs in the queue.
+//Every written record is also added to summary and recorded in index, unless they are 0.
+std::vector<RunResult>
+RunJobs (const std::vector<ScenarioParams> &jobs, int workers, const ResultWriter &writer,
+         const std::vector<ResultWriter> &detailWriters, SweepSummary *summary, ResultIndex *index)
+{
+  std::vector<RunResult> results (jobs.size ());
+  std::vector<std::vector<EncodedRecords> > details (jobs.size ());
+  std::vector<bool> done (jobs.size (), false);
+  size_t written = 0;
+
+  std::vector<size_t> groupStart;
+  std::vector<double> costs;
+  for (size_t j = 0; j < jobs.size (); ++j)
+    {
+      if (j == 0 || jobs[j].warmup <= 0.0 || !SameScenario (jobs[j - 1], jobs[j]))
+        {
+          groupStart.push_back (j);
+          costs.push_back (0.0);
+        }
+      costs.back () += EstimateCost (jobs[j]);
+    }
+  groupStart.push_back (jobs.size ());
+
+  if (workers <= 0)
+    {
+      for (size_t g = 0; g + 1 < groupStart.size (); ++g)
+        {
+          std::string out = RunGroup (jobs, groupStart[g], groupStart[g + 1], detailWriters);
+          UnpackGroup (out, true, groupStart[g], groupStart[g + 1], detailWriters.size (), results, details);
+          for (size_t j = groupStart[g]; j < groupStart[g + 1]; ++j)
+            {
+              done[j] = true;
+            }
+          WriteCompleted (jobs, results, details, done, written, writer, detailWriters, summary, index);
+        }
+      return results;
+    }
+
+  std::vector<size_t> queue;
+  for (size_t g = 0; g < costs.size (); ++g)
+    {
+      queue.push_back (g);
+    }
+  CostOrder order;
+  order.costs = &costs;
+  std::stable_sort (queue.begin (), queue.end (), order);
+
+  std::vector<Worker> running;
+  size_t next = 0;
+  while (next < queue.size () || !running.empty ())
+    {
+      while (next < queue.size () && (int)running.size () < workers)
+        {
+          size_t group = queue[next++];
+          int fds[2];
+          if (pipe (fds) != 0)
+            {
+              NS_FATAL_ERROR ("pipe() failed: " << strerror (errno));
+            }
+          std::cout.flush (); //do not let the child inherit and repeat buffered output
+          pid_t pid = fork ();
+          if (pid < 0)
+            {
+              NS_FATAL_ERROR ("fork() failed: " << strerror (errno));
+            }
+          if (pid == 0)
+            {
+              close (fds[0]);
+              WriteAll (fds[1], RunGroup (jobs, groupStart[group], groupStart[group + 1], detailWriters));
+              close (fds[1]);
+              std::cout.flush ();
+              _exit (0);
+            }
+          close (fds[1]);
+          Worker worker;
+          worker.pid = pid;
+          worker.fd = fds[0];
+          worker.first = groupStart[group];
+          worker.last = groupStart[group + 1];
+          running.push_back (worker);
+        }
+
+      std::vector<struct pollfd> polled (running.size ());
+      for (size_t i = 0; i < running.size (); ++i)
+        {
+          polled[i].fd = running[i].fd;
+          polled[i].events = POLLIN;
+          polled[i].revents = 0;
+        }
+      if (poll (&polled[0], polled.size (), -1) < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          NS_FATAL_ERROR ("poll() failed: " << strerror (errno));
+        }
+      for (size_t i = running.size (); i-- > 0; )
+        {
+          if (polled[i].revents == 0)
+            {
+              continue;
+            }
+          char buffer[4096];
+          ssize_t n = read (running[i].fd, buffer, sizeof (buffer));
+          if (n > 0)
+            {
+              running[i].output.append (buffer, n);
+              continue;
+            }
+          if (n < 0 && errno == EINTR)
+            {
+              continue;
+            }
+          close (running[i].fd);
+          int status = 0;
+          waitpid (running[i].pid, &status, 0);
+          UnpackGroup (running[i].output, WIFEXITED (status) && WEXITSTATUS (status) == 0,
+                       running[i].first, running[i].last, detailWriters.size (), results, details);
+          for (size_t j = running[i].first; j < running[i].last; ++j)
+            {
+              done[j] = true;
+            }
+          running.erase (running.begin () + i);
+        }
+      WriteCompleted (jobs, results, details, done, written, writer, detailWriters, summary, index);
+    }
+  return results;
+}
+
+//One (rayleigh, manager, distance, nodeNum) point of an adaptive sweep, its throughputs are in the SweepSummary
+struct SweepPoint
+{
+  ScenarioParams params; //params.seed is the first seed run for the point
+  int nextSeed;
+  int lastSeed;
+  int seedsRun;
+  bool converged;
+  size_t baseline; //paired: the point of the first manager with the same rayleigh, distance and nodeNum
+};
+
+//Run one round of sweep jobs, jobPoint[j] being the point of jobs[j]. Jobs found in index are not run again:
+//their records are already in the result files from the earlier run, so they only go into summary.
+void
+RunRound (const std::vector<ScenarioParams> &jobs, const std::vector<size_t> &jobPoint, int workers,
+          const ResultWriter &writer, const std::vector<ResultWriter> &detailWriters, SweepSummary &summary,
+          ResultIndex &index)
+{
+  std::vector<ScenarioParams> pending;
+  std::vector<size_t> pendingPoint;
+  std::vector<size_t> cachedPoint;
+  std::vector<int> cachedSeed;
+  std::vector<RunResult> cached;
+  for (size_t j = 0; j < jobs.size (); ++j)
+    {
+      RunResult result;
+      if (index.Find (jobs[j], result))
+        {
+          cachedPoint.push_back (jobPoint[j]);
+          cachedSeed.push_back (jobs[j].seed);
+          cached.push_back (result);
+        }
+      else
+        {
+          pending.push_back (jobs[j]);
+          pendingPoint.push_back (jobPoint[j]);
+        }
+    }
+  if (!cached.empty ())
+    {
+      std::cout << cached.size () << " of " << jobs.size () << " runs taken from the result index" << std::endl;
+      summary.SetJobPoints (cachedPoint);
+      for (size_t j = 0; j < cached.size (); ++j)
+        {
+          summary.Add (j, cachedSeed[j], cached[j]);
+        }
+      summary.Write ();
+    }
+  summary.SetJobPoints (pendingPoint);
+  RunJobs (pending, workers, writer, detailWriters, &summary, &index);
+}
+
+//Run the whole (rayleigh, manager, distance, nodeNum, seed) grid, possibly over several worker processes.
+//With ciTarget > 0 the seeds are only the first round: every point whose 95% confidence interval of the
+//mean throughput is wider than ciTarget times the mean gets further seeds, in rounds, until it is narrow
+//enough or has run maxSeeds seeds. The interval of every point is then written to ciWriter. Throughout the
+//sweep summaryWriter and plotWriter hold the running statistics of every point, see SweepSummary; the plot
+//runs over nodeNum when more than one is swept, else over distance. Runs of the build buildId already in
+//the index file indexFileName are served from it, see ResultIndex.
+//With paired, every manager is compared with the first one on common random numbers: the points of one
+//(rayleigh, distance, nodeNum) always run the same seeds, and as every draw of a run comes from the
+//per-node streams of its seed (see NodeStream), the managers see the same placement, traffic directions,
+//start times and loads. Of the fading models only block gives them the same fading as well: nakagami and
+//batch draw per frame and ar1 per link use, so their gains follow each manager's own frame timing (main
+//warns about it). pairedWriter gets the per-seed throughput differences and their CI, and ciTarget
+//applies to the CI of the differences, as a fraction of the first manager's mean throughput.
+void
+RunSweep (const ScenarioParams &defaults, int workers, const ResultWriter &writer,
+          const std::vector<ResultWriter> &detailWriters,
+          const std::vector<double> &rayleighs, const std::vector<std::string> &managers,
+          const std::vector<double> &distances, const std::vector<double> &nodeNums,
+          const std::vector<double> &seeds, double ciTarget, int maxSeeds, bool paired, const ResultWriter &ciWriter,
+          const ResultWriter &summaryWriter, const ResultWriter &plotWriter, const ResultWriter &pairedWriter,
+          const std::string &indexFileName, const std::string &buildId)
+{
+  ResultIndex index (indexFileName, buildId);
+  bool byNodeNum = nodeNums.size () > 1;
+  paired = paired && managers.size () > 1;
+  SweepSummary summary (summaryWriter, plotWriter, pairedWriter, byNodeNum ? "nodeNum" : "distance");
+  std::vector<SweepPoint> points;
+  std::vector<ScenarioParams> jobs;
+  std::vector<size_t> jobPoint;
+  for (size_t r = 0; r < rayleighs.size (); ++r)
+    {
+      for (size_t m = 0; m < managers.size (); ++m)
+        {
+          for (size_t d = 0; d < distances.size (); ++d)
+            {
+              for (size_t n = 0; n < nodeNums.size (); ++n)
+                {
+                  SweepPoint point;
+                  point.params = defaults;
+                  point.params.rayleigh = rayleighs[r] != 0.0;
+                  point.params.manager = managers[m];
+                  point.params.cara = managers[m] == "Cara";
+                  point.params.distance = distances[d];
+                  point.params.nodeNum = (int)nodeNums[n];
+                  point.params.seed = seeds.empty () ? defaults.seed : (int)seeds[0];
+                  point.nextSeed = point.params.seed;
+                  point.lastSeed = point.params.seed;
+                  point.seedsRun = 0;
+                  point.converged = false;
+                  point.baseline = ((r * managers.size ()) * distances.size () + d) * nodeNums.size () + n;
+                  std::ostringstream series;
+                  series << managers[m] << (point.params.rayleigh ? "+rayleigh" : "");
+                  if (byNodeNum && distances.size () > 1)
+                    {
+                      series << "@" << distances[d] << "m";
+                    }
+                  summary.AddPoint (point.params, series.str (), byNodeNum ? nodeNums[n] : distances[d]);
+                  if (paired && m > 0)
+                    {
+                      summary.Pair (points.size (), point.baseline);
+                    }
+                  for (size_t s = 0; s < seeds.size (); ++s)
+                    {
+                      ScenarioParams params = point.params;
+                      params.seed = (int)seeds[s];
+                      point.nextSeed = std::max (point.nextSeed, params.seed + 1);
+                      point.lastSeed = params.seed;
+                      ++point.seedsRun;
+                      jobs.push_back (params);
+                      jobPoint.push_back (points.size ());
+                    }
+                  points.push_back (point);
+                }
+            }
+        }
+    }
+
+  //every run the sweep may make that the index does not have, the later seeds of open points included,
+  //loses its earlier records in one pass over the files
+  std::vector<ScenarioParams> reruns;
+  RunResult unused;
+  for (size_t j = 0; j < jobs.size (); ++j)
+    {
+      if (!index.Find (jobs[j], unused))
+        {
+          reruns.push_back (jobs[j]);
+        }
+    }
+  for (size_t p = 0; p < points.size () && ciTarget > 0.0; ++p)
+    {
+      ScenarioParams params = points[p].params;
+      params.seed = points[p].nextSeed;
+      for (int s = points[p].seedsRun; s < maxSeeds; ++s, ++params.seed)
+        {
+          if (!index.Find (params, unused))
+            {
+              reruns.push_back (params);
+            }
+        }
+    }
+  DropRuns (reruns, writer, detailWriters);
+
+  summary.Write ();
+  if (ciTarget <= 0.0)
+    {
+      RunRound (jobs, jobPoint, workers, writer, detailWriters, summary, index);
+      return;
+    }
+  while (!jobs.empty ())
+    {
+      RunRound (jobs, jobPoint, workers, writer, detailWriters, summary, index);
+
+      //each open point gets one more seed, more while that still leaves workers idle
+      std::vector<size_t> open;
+      for (size_t p = 0; p < points.size (); ++p)
+        {
+          const RunningStats &throughput = summary.GetThroughput (p);
+          points[p].converged = throughput.GetHalfWidth () <= ciTarget * std::fabs (throughput.GetMean ());
+        }
+      if (paired)
+        {
+          //a baseline has converged once all its pairs have; the points of a pair stay open together
+          for (size_t p = 0; p < points.size (); ++p)
+            {
+              points[p].converged = points[p].baseline == p;
+            }
+          for (size_t p = 0; p < points.size (); ++p)
+            {
+              size_t baseline = points[p].baseline;
+              if (baseline != p)
+                {
+                  double mean = summary.GetThroughput (baseline).GetMean ();
+                  points[p].converged = summary.GetDifference (p).GetHalfWidth () <= ciTarget * std::fabs (mean);
+                  points[baseline].converged = points[baseline].converged && points[p].converged;
+                }
+            }
+        }
+      for (size_t p = 0; p < points.size (); ++p)
+        {
+          bool converged = paired ? points[points[p].baseline].converged : points[p].converged;
+          if (!converged && points[p].seedsRun < maxSeeds)
+            {
+              open.push_back (p);
+            }
+        }
+      size_t batch = open.empty () ? 0 : std::max<size_t> (1, workers / open.size ());
+      jobs.clear ();
+      jobPoint.clear ();
+      for (size_t i = 0; i < open.size (); ++i)
+        {
+          SweepPoint &point = points[open[i]];
+          for (size_t b = 0; b < batch && point.seedsRun < maxSeeds; ++b)
+            {
+              ScenarioParams params = point.params;
+              params.seed = point.lastSeed = point.nextSeed++;
+              ++point.seedsRun;
+              jobs.push_back (params);
+              jobPoint.push_back (open[i]);
+            }
+        }
+    }
+
+  for (size_t p = 0; p < points.size (); ++p)
+    {
+      const RunningStats &throughput = summary.GetThroughput (p);
+      double mean = throughput.GetMean ();
+      double halfWidth = throughput.GetHalfWidth ();
+      ResultRecord record;
+      AddParams (record, points[p].params);
+      record.Add ("lastSeed", points[p].lastSeed);
+      record.Add ("seeds", throughput.GetN ());
+      record.Add ("meanThroughput", mean);
+      record.Add ("ciHalfWidth", halfWidth);
+      record.Add ("ciRelative", mean != 0.0 ? halfWidth / std::fabs (mean) : std::numeric_limits<double>::infinity ());
+      record.Add ("converged", points[p].converged);
+      ciWriter.Write (record);
+    }
+}
+
+//Strip leading and trailing blanks
+std::string
+Trim (const std::string &text)
+{
+  size_t first = text.find_first_not_of (" \t\r");
+  if (first == std::string::npos)
+    {
+      return std::string ();
+    }
+  return text.substr (first, text.find_last_not_of (" \t\r") - first + 1);
+}
+
+//Read a scenario file, an INI file of "name = value" lines whose names are those of the command-line
+//options of main, or ns3:: attribute paths as on any ns-3 command line. [section] headers only group the
+//lines, lines starting with # or ; are comments. The entries come back as --name=value arguments.
+std::vector<std::string>
+LoadScenarioFile (const std::string &fileName)
+{
+  std::ifstream in (fileName.c_str ());
+  if (!in)
+    {
+      NS_FATAL_ERROR ("cannot open scenario file " << fileName);
+    }
+  std::vector<std::string> arguments;
+  std::string line;
+  for (int number = 1; std::getline (in, line); ++number)
+    {
+      std::string text = Trim (line);
+      if (text.empty () || text[0] == '#' || text[0] == ';' || (text[0] == '[' && text[text.size () - 1] == ']'))
+        {
+          continue;
+        }
+      size_t equals = text.find ('=');
+      if (equals == std::string::npos || Trim (text.substr (0, equals)).empty ())
+        {
+          NS_FATAL_ERROR (fileName << ":" << number << ": expected name = value, got " << text);
+        }
+      arguments.push_back ("--" + Trim (text.substr (0, equals)) + "=" + Trim (text.substr (equals + 1)));
+    }
+  return arguments;
+}
+
+int
+main (int argc, char *argv[])
+{
+  bool verbose = true;
+  bool logPackets = false;
+  bool rayleigh = false;
+  int seed= 4;
+  double distance = 5.0;
+  bool cara =false;
+  int nodeNum = 1;
+  bool sweep = false;
+  int workers = 0;
+  std::string rayleighs = "false";
+  std::string caras = "false,true";
+  std::string manager = "";
+  std::string managers = "";
+  std::string managerAttributes = "";
+  std::string distances = "5";
+  std::string nodeNums = "1:46:5";
+  std::string seeds = "1:5";
+  double ciTarget = 0.0;
+  int maxSeeds = 20;
+  bool paired = false;
+  double warmup = 0.0;
+  bool profile = false;
+  bool resume = true;
+  std::string buildId = "";
+  bool lossCache = true;
+  std::string fading = "nakagami";
+  double coherenceTime = 0.05;
+  std::string traffic = "cbr";
+  std::string dataRate = "20Mib/s"; //data rate set as a string, see documentation for accepted units
+  int packetSize = 1024;
+  std::string load = "";
+  std::string onTime = "ns3::ParetoRandomVariable[Mean=0.5|Shape=1.5]";
+  std::string offTime = "ns3::ExponentialRandomVariable[Mean=0.5]";
+  std::string measure = "sink";
+  std::string mobility = "static";
+  double speed = 1.0;
+  double mobilityBounds = 100.0;
+  std::string replication = "seed";
+  int rngSeed = 1;
+  std::string fileName = "default.csv";
+  std::string format = "csv";
+  bool details = true;
+  double sampleInterval = 0.0;
+  int sampleCapacity = 0;
+  int apNum = 1;
+  std::string apLayout = "grid";
+  double apSpacing = 50.0;
+  std::string channels = "1";
+  double stopTime = 10.0;
+  std::string ssid = "example-ssid";
+  std::string addressBase = "10.1.1.0";
+  int port = 8000;
+  double lossExponent = 3.0;
+  std::string placement = "disc";
+  std::string stationRho = "ns3::ConstantRandomVariable[Constant=10.0]";
+  std::string direction = "random";
+  std::string throughputUnit = "Mbps";
+  std::string scenarioFile = "";
+  bool frameTrace = false;
+  CommandLine cmd;
+  cmd.AddValue ("verbose", "Print the per-station MAC/PHY counters of every run", verbose); //parameter name, description, variable that will take the value read from the command line
+  cmd.AddValue ("logPackets", "Tell packet sinks to log every packet if true", logPackets);
+  cmd.AddValue ("seed", "SEED",seed);
+  cmd.AddValue ("file", "Output to file",fileName);
+  cmd.AddValue ("format", "result file format, csv or bin",format);
+  cmd.AddValue ("details", "also write per-flow, sampler, per-station and per-BSS records to <file>.flows/.samples/.stations/.bss.<ext>",details);
+  cmd.AddValue ("sampleInterval", "seconds between per-station throughput/rate/retry samples, 0 disables the sampler",sampleInterval);
+  cmd.AddValue ("apNum", "number of BSSs, each with one AP and nodeNum stations around it",apNum);
+  cmd.AddValue ("apLayout", "AP placement, grid or hex",apLayout);
+  cmd.AddValue ("apSpacing", "distance between neighbouring APs in metres",apSpacing);
+  cmd.AddValue ("channels", "channel numbers assigned to the BSSs in turn, e.g. 1,6,11",channels);
+  cmd.AddValue ("sampleCapacity", "samples held in the preallocated ring buffer, 0 sizes it for the whole run",sampleCapacity);
+  cmd.AddValue ("distance", "distance between node and AP",distance);
+  cmd.AddValue ("cara","activate CARA",cara);
+  cmd.AddValue ("rayleigh","activate rayleigh",rayleigh);
+  cmd.AddValue ("nodeNum","number of station nodes",nodeNum);
+  cmd.AddValue ("sweep","run the whole grid given by rayleighs/caras/distances/nodeNums/seeds",sweep);
+  cmd.AddValue ("workers","sweep: number of parallel worker processes, 0 runs every point in this process",workers);
+  cmd.AddValue ("rayleighs","sweep: rayleigh values, e.g. false,true",rayleighs);
+  cmd.AddValue ("caras","sweep: cara values, e.g. false,true, used when managers is not given",caras);
+  cmd.AddValue ("manager","rate adaptation by WifiRemoteStationManager name, e.g. Minstrel, Ideal, Onoe, Amrr, Aarfcd, ConstantRate; overrides cara",manager);
+  cmd.AddValue ("managers","sweep: rate adaptations, e.g. Aarf,Cara,Minstrel; overrides caras",managers);
+  cmd.AddValue ("managerAttributes","attributes of the manager as Name=Value,Name=Value, e.g. DataMode=ErpOfdmRate54Mbps",managerAttributes);
+  cmd.AddValue ("distances","sweep: distances as first:last:step or a list",distances);
+  cmd.AddValue ("nodeNums","sweep: station counts as first:last:step or a list",nodeNums);
+  cmd.AddValue ("seeds","sweep: seeds as first:last:step or a list",seeds);
+  cmd.AddValue ("ciTarget","sweep: add seeds until the 95% CI half width is below this fraction of the mean throughput, 0 runs exactly the given seeds",ciTarget);
+  cmd.AddValue ("fading","rayleigh fading model: nakagami (m=1 Nakagami), batch (same statistics, counter-based gains generated in batches per station-AP link), "
+                "block (gain held per link for coherenceTime) or ar1 (gain evolving as a Jakes AR(1) process)",fading);
+  cmd.AddValue ("coherenceTime","seconds the fading of a link stays correlated, for fading=block and fading=ar1",coherenceTime);
+  cmd.AddValue ("traffic","traffic profile: cbr, bursty (on-off with onTime/offTime periods), mixed (cbr with an IMIX size drawn per packet) or bulk (TCP BulkSend)",traffic);
+  cmd.AddValue ("dataRate","rate of every sender while on, e.g. 20Mib/s",dataRate);
+  cmd.AddValue ("packetSize","application payload bytes per packet",packetSize);
+  cmd.AddValue ("load","per-station offered load in Mbit/s drawn from a random variable, e.g. ns3::ExponentialRandomVariable[Mean=5]; empty uses dataRate",load);
+  cmd.AddValue ("onTime","bursty: random variable of the on periods in seconds",onTime);
+  cmd.AddValue ("offTime","bursty: random variable of the off periods in seconds",offTime);
+  cmd.AddValue ("measure","sink counts packets and bytes per station at the senders and packet sinks, "
+                "flowmon installs FlowMonitor for per-flow delay, jitter, loss and histograms",measure);
+  cmd.AddValue ("mobility","stations static, walk (random walk, new direction every second), waypoint (random waypoint) "
+                "or away (constant velocity away from the AP); the .samples file gets their distance to the AP",mobility);
+  cmd.AddValue ("speed","m/s of moving stations",speed);
+  cmd.AddValue ("mobilityBounds","half width in metres of the square around its AP that walking and waypoint stations stay in",mobilityBounds);
+  cmd.AddValue ("replication","run: seed/seeds are run numbers under the fixed rngSeed (ns-3's recommended replication), "
+                "seed: they are the ns-3 seed itself, as in the baseline study",replication);
+  cmd.AddValue ("rngSeed","ns-3 seed shared by all runs of replication=run",rngSeed);
+  cmd.AddValue ("lossCache","compute the log-distance loss once per node pair instead of once per frame, for static topologies "
+                "(beyond 1024 nodes only the station-AP links)",lossCache);
+  cmd.AddValue ("profile","count scheduled events per type into <file>.events.<ext> and per second into the result records",profile);
+  cmd.AddValue ("warmup","sweep: build and associate each point once for this many seconds, then fork per seed to run only the measured window; "
+                "the seeds share the association and BSS of the seed-1 build and its warm-up, and get their own station "
+                "positions and freshly reset rate managers",warmup);
+  cmd.AddValue ("resume","sweep: skip runs already recorded in <file>.index.<ext> by the same buildId with the same parameters and result columns, "
+                "their records are in the result files",resume);
+  cmd.AddValue ("buildId","sweep: identity of this build of the program, the scripts pass a hash of template.cc; "
+                "part of the result index key, without it resume is off",buildId);
+  cmd.AddValue ("paired","sweep: compare every manager with the first one seed by seed on common random numbers, "
+                "into <file>.paired.<ext>; ciTarget then applies to the throughput differences. "
+                "With rayleigh only fading=block is common to the managers",paired);
+  cmd.AddValue ("maxSeeds","sweep: most seeds run for one point when ciTarget is set",maxSeeds);
+  cmd.AddValue ("stopTime","seconds simulated per run",stopTime);
+  cmd.AddValue ("ssid","SSID of the BSS, BSS k of several gets <ssid>-k",ssid);
+  cmd.AddValue ("addressBase","network of the /24 the nodes are numbered from",addressBase);
+  cmd.AddValue ("port","port of the measured flows",port);
+  cmd.AddValue ("lossExponent","path loss exponent of the log-distance loss; --ns3::LogDistancePropagationLossModel::Exponent "
+                "overrides it when given",lossExponent);
+  cmd.AddValue ("placement","stations on a disc around their AP given by stationRho, or distance (distance metres east of it, task1)",placement);
+  cmd.AddValue ("stationRho","placement=disc: random variable of the distance of a station to its AP",stationRho);
+  cmd.AddValue ("direction","traffic of every station: random (drawn per station), uplink or downlink",direction);
+  cmd.AddValue ("throughputUnit","Mbps (over all but the first second) or Kib/s (over the whole run, task1)",throughputUnit);
+  cmd.AddValue ("frameTrace","write the per-frame events of every run to its own <file>-<run>.trc binary trace, "
+                "see traceanalyzer.cc; runs are not taken from the result index then",frameTrace);
+  cmd.AddValue ("scenario","INI file of name = value lines, each taken as --name=value before the command line, "
+                "which overrides it; see the taskN.ini files",scenarioFile);
+
+  //the scenario file is read once, ahead of the command line, and the whole sweep runs from its values
+  std::vector<std::string> arguments (1, argv[0]);
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string argument = argv[i];
+      if (argument.compare (0, 11, "--scenario=") == 0)
+        {
+          std::vector<std::string> entries = LoadScenarioFile (argument.substr (11));
+          arguments.insert (arguments.end (), entries.begin (), entries.end ());
+        }
+    }
+  arguments.insert (arguments.end (), argv + 1, argv + argc);
+  std::string attributes;
+  std::string exponentAttribute = "--ns3::LogDistancePropagationLossModel::Exponent=";
+  std::string exponent; //value of exponentAttribute when given, which wins over lossExponent
+  std::vector<char *> argp;
+  for (size_t i = 0; i < arguments.size (); ++i)
+    {
+      if (arguments[i].compare (0, 7, "--ns3::") == 0)
+        {
+          attributes += (attributes.empty () ? "" : ",") + arguments[i].substr (2);
+        }
+      if (arguments[i].compare (0, exponentAttribute.size (), exponentAttribute) == 0)
+        {
+          exponent = arguments[i].substr (exponentAttribute.size ());
+        }
+      argp.push_back (&arguments[i][0]);
+    }
+  argp.push_back (0);
+  cmd.Parse ((int)arguments.size (), &argp[0]);
+
+  if (profile)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::ProfilingSimulatorImpl"));
+    }
+  if (logPackets)
+    {
+      LogComponentEnable ("PacketSink", LOG_LEVEL_INFO); //packet sink should write all actions to the command line
+    }
+
+  ScenarioParams params;
+  params.rayleigh = rayleigh;
+  params.cara = cara;
+  params.seed = seed;
+  params.distance = distance;
+  params.nodeNum = nodeNum;
+  params.sampleInterval = sampleInterval;
+  params.sampleCapacity = sampleCapacity;
+  params.verbose = verbose;
+  params.apNum = apNum;
+  params.apLayout = apLayout;
+  params.apSpacing = apSpacing;
+  params.channels = channels;
+  params.warmup = warmup;
+  params.lossCache = lossCache;
+  params.fading = fading;
+  params.coherenceTime = coherenceTime;
+  params.manager = manager.empty () ? (cara ? "Cara" : "Aarf") : manager;
+  params.cara = params.manager == "Cara";
+  params.managerAttributes = managerAttributes;
+  params.traffic = traffic;
+  params.dataRate = dataRate;
+  params.packetSize = packetSize;
+  params.load = load;
+  params.onTime = onTime;
+  params.offTime = offTime;
+  params.measure = measure;
+  params.mobility = mobility;
+  params.speed = speed;
+  params.mobilityBounds = mobilityBounds;
+  params.replication = replication;
+  params.rngSeed = rngSeed;
+  params.stopTime = stopTime;
+  params.ssid = ssid;
+  params.addressBase = addressBase;
+  params.port = port;
+  params.lossExponent = exponent.empty () ? lossExponent : atof (exponent.c_str ());
+  params.placement = placement;
+  params.stationRho = stationRho;
+  params.direction = direction;
+  params.throughputUnit = throughputUnit;
+  params.attributes = attributes;
+  params.frameTrace = frameTrace ? fileName : std::string ();
+  std::vector<std::string> managerList = SplitList (managers, ',');
+  if (managerList.empty ())
+    {
+      std::vector<double> caraList = ParseRange (caras);
+      for (size_t c = 0; c < caraList.size (); ++c)
+        {
+          managerList.push_back (caraList[c] != 0.0 ? "Cara" : "Aarf");
+        }
+    }
+  managerList.push_back (params.manager);
+  for (size_t m = 0; m < managerList.size (); ++m)
+    {
+      TypeId tid;
+      if (!TypeId::LookupByNameFailSafe (ManagerTypeName (managerList[m]), &tid))
+        {
+          NS_FATAL_ERROR ("unknown station manager " << managerList[m]);
+        }
+    }
+  managerList.pop_back ();
+  if (fading != "nakagami" && fading != "batch" && fading != "block" && fading != "ar1")
+    {
+      NS_FATAL_ERROR ("unknown fading model " << fading);
+    }
+  if ((fading == "block" || fading == "ar1") && coherenceTime <= 0.0)
+    {
+      NS_FATAL_ERROR ("fading=" << fading << " needs a positive coherenceTime");
+    }
+  if (sweep && resume && !frameTrace && buildId.empty ())
+    {
+      std::cout << "resume off: no --buildId to tell this build's runs in the index from those of other builds" << std::endl;
+    }
+  std::vector<double> rayleighList = ParseRange (rayleighs);
+  if (sweep && paired && managerList.size () > 1 && fading != "block"
+      && (size_t)std::count (rayleighList.begin (), rayleighList.end (), 0.0) < rayleighList.size ())
+    {
+      std::cout << "paired: fading=" << fading << " follows the frame timing of each manager, so the rayleigh points are "
+                << "paired on placement and traffic but not on fading; fading=block pairs the fading too" << std::endl;
+    }
+  if (traffic != "cbr" && traffic != "bursty" && traffic != "mixed" && traffic != "bulk")
+    {
+      NS_FATAL_ERROR ("unknown traffic profile " << traffic);
+    }
+  if (measure != "sink" && measure != "flowmon")
+    {
+      NS_FATAL_ERROR ("unknown measurement " << measure);
+    }
+  if (mobility != "static" && mobility != "walk" && mobility != "waypoint" && mobility != "away")
+    {
+      NS_FATAL_ERROR ("unknown mobility " << mobility);
+    }
+  if (replication != "run" && replication != "seed")
+    {
+      NS_FATAL_ERROR ("unknown replication " << replication);
+    }
+  if (placement != "disc" && placement != "distance")
+    {
+      NS_FATAL_ERROR ("unknown placement " << placement);
+    }
+  if (direction != "random" && direction != "uplink" && direction != "downlink")
+    {
+      NS_FATAL_ERROR ("unknown direction " << direction);
+    }
+  if (throughputUnit != "Mbps" && throughputUnit != "Kib/s")
+    {
+      NS_FATAL_ERROR ("unknown throughputUnit " << throughputUnit);
+    }
+  if (packetSize <= 0)
+    {
+      NS_FATAL_ERROR ("packetSize must be positive");
+    }
+  if (stopTime <= 1.0)
+    {
+      NS_FATAL_ERROR ("stopTime must be over 1 s, the senders start within the first 0.1 s");
+    }
+  if (port <= 0 || port > 65535)
+    {
+      NS_FATAL_ERROR ("port out of range: " << port);
+    }
+
+  ResultWriter writer (fileName, format == "bin");
+  std::vector<ResultWriter> detailWriters;
+  if (details)
+    {
+      for (int kind = 0; kind < DETAIL_KINDS; ++kind)
+        {
+          detailWriters.push_back (ResultWriter (DetailFileName (fileName, detailNames[kind]), format == "bin"));
+        }
+    }
+  if (sweep)
+    {
+      RunSweep (params, workers, writer, detailWriters, ParseRange (rayleighs), managerList,
+                ParseRange (distances), ParseRange (nodeNums), ParseRange (seeds), ciTarget, maxSeeds, paired,
+                ResultWriter (DetailFileName (fileName, "ci"), format == "bin"),
+                ResultWriter (DetailFileName (fileName, "summary"), format == "bin"),
+                ResultWriter (DetailFileName (fileName, "plot"), format == "bin"),
+                ResultWriter (DetailFileName (fileName, "paired"), format == "bin"),
+                resume && !frameTrace ? DetailFileName (fileName, "index") : std::string (), buildId);
+      return 0;
+    }
+
+  DropRuns (std::vector<ScenarioParams> (1, params), writer, detailWriters);
+  RunJobs (std::vector<ScenarioParams> (1, params), 0, writer, detailWriters, 0, 0);
+
+  return 0;
+}
@@ -0,0 +1,444 @@
+//Offline analysis of the binary per-frame traces template.cc writes with --frameTrace=true, so an odd
+//result can be looked into without running the simulation again. Plain C++, no ns-3 needed:
+//
+//  g++ -O2 -o traceanalyzer traceanalyzer.cc
+//  ./traceanalyzer [--station=<node>] [--bin=<seconds>] [--only=rates|retries|timeline] <file.trc>...
+//
+//For every trace it prints
+//  rates     data frames sent per rate, per station link and over all links
+//  retries   retry chains of data frames per transmitter and link: attempts per frame, frames given up or open
+//  timeline  per station link and time bin: data frames, retries, failures, mean rate and mean SNR
+//The record layout is a copy of FrameTraceHeader/FrameRecord in template.cc and must stay in sync with it.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+enum FrameEvent
+{
+  FRAME_TX,
+  FRAME_RX,
+  FRAME_RX_DROP,
+  FRAME_DATA_FAILED,
+  FRAME_FINAL_FAILED,
+  FRAME_RTS_FAILED
+};
+
+enum FrameFlags
+{
+  FRAME_DATA = 1,
+  FRAME_RTS = 2,
+  FRAME_CTS = 4,
+  FRAME_ACK = 8,
+  FRAME_RETRY = 16
+};
+
+struct FrameTraceHeader
+{
+  char magic[8];
+  uint32_t recordSize;
+  uint32_t headerSize;
+  uint64_t records;
+  char run[232];
+};
+
+struct FrameRecord
+{
+  double time;
+  uint32_t node;
+  uint32_t link;
+  uint32_t rateKbps;
+  float snrDb;
+  uint32_t size;
+  uint8_t kind;
+  uint8_t flags;
+  uint16_t reserved;
+};
+
+struct Options
+{
+  long station; //only this station link, -1 for all
+  double bin; //seconds per timeline bin
+  std::string only; //one section, empty for all
+};
+
+const int maxAttempts = 8; //the last retry column takes every chain this long or longer
+
+//Retry chains of one transmitter on one link
+struct RetryChains
+{
+  int attempts; //attempts of the open chain, 0 if none is open
+  uint64_t delivered[maxAttempts]; //delivered chains by attempts
+  uint64_t givenUp;
+  uint64_t open; //chains still open at the end of the trace, their outcome is not in it
+  uint64_t rtsFailed;
+};
+
+//One time bin of one link in the timeline
+struct TimelineBin
+{
+  uint64_t frames;
+  uint64_t retries;
+  uint64_t failed;
+  double rateSum;
+  double snrSum;
+  uint64_t snrs;
+};
+
+//A trace file mapped read-only
+class TraceFile
+{
+public:
+  TraceFile (const std::string &fileName)
+    : m_data (0),
+      m_size (0),
+      m_records (0)
+  {
+    int fd = open (fileName.c_str (), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat (fd, &st) != 0)
+      {
+        m_error = strerror (errno);
+        if (fd >= 0)
+          {
+            close (fd);
+          }
+        return;
+      }
+    m_size = st.st_size;
+    if (m_size >= sizeof (FrameTraceHeader))
+      {
+        void *data = mmap (0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        m_data = data == MAP_FAILED ? 0 : static_cast<const char *> (data);
+      }
+    close (fd);
+    const FrameTraceHeader *header = GetHeader ();
+    if (header == 0 || memcmp (header->magic, "WIFITRC1", sizeof (header->magic)) != 0
+        || header->recordSize != sizeof (FrameRecord) || header->headerSize != sizeof (FrameTraceHeader))
+      {
+        m_error = "not a frame trace of this version";
+        return;
+      }
+    CountRecords ();
+  }
+  ~TraceFile ()
+  {
+    if (m_data != 0)
+      {
+        munmap (const_cast<char *> (m_data), m_size);
+      }
+  }
+  const std::string &GetError (void) const
+  {
+    return m_error;
+  }
+  const FrameTraceHeader *GetHeader (void) const
+  {
+    return m_data != 0 ? reinterpret_cast<const FrameTraceHeader *> (m_data) : 0;
+  }
+  //Records in the trace, see CountRecords
+  uint64_t GetN (void) const
+  {
+    return m_records;
+  }
+  const FrameRecord &Get (uint64_t i) const
+  {
+    return reinterpret_cast<const FrameRecord *> (m_data + sizeof (FrameTraceHeader))[i];
+  }
+
+private:
+  TraceFile (const TraceFile &);
+  TraceFile &operator= (const TraceFile &);
+
+  //The header count once the trace was closed. A run killed before that leaves it 0 and the file grown
+  //in whole zero-filled windows, so the records then end at the first all-zero one; no real record is
+  //all zero, a transmission has a size and every other event a NaN or nonzero SNR or kind.
+  void CountRecords (void)
+  {
+    uint64_t fit = (m_size - sizeof (FrameTraceHeader)) / sizeof (FrameRecord);
+    uint64_t records = GetHeader ()->records;
+    if (records != 0)
+      {
+        m_records = std::min (records, fit);
+        return;
+      }
+    FrameRecord zero;
+    memset (&zero, 0, sizeof (zero));
+    while (m_records < fit && memcmp (&Get (m_records), &zero, sizeof (zero)) != 0)
+      {
+        ++m_records;
+      }
+  }
+
+  const char *m_data;
+  size_t m_size;
+  uint64_t m_records;
+  std::string m_error;
+};
+
+bool
+Selected (const Options &options, const FrameRecord &record)
+{
+  return options.station < 0 || record.link == (uint32_t)options.station;
+}
+
+bool
+IsDataTx (const FrameRecord &record)
+{
+  return record.kind == FRAME_TX && (record.flags & FRAME_DATA);
+}
+
+//Data frames sent per rate, per link and in total
+void
+PrintRates (const TraceFile &trace, const Options &options)
+{
+  std::map<uint32_t, std::map<uint32_t, uint64_t> > perLink;
+  std::map<uint32_t, uint64_t> total;
+  uint64_t frames = 0;
+  for (uint64_t i = 0; i < trace.GetN (); ++i)
+    {
+      const FrameRecord &record = trace.Get (i);
+      if (IsDataTx (record) && Selected (options, record))
+        {
+          ++perLink[record.link][record.rateKbps];
+          ++total[record.rateKbps];
+          ++frames;
+        }
+    }
+  std::cout << "rates" << std::endl;
+  std::cout << std::setw (8) << "link" << std::setw (12) << "rate Mbps" << std::setw (12) << "frames"
+            << std::setw (10) << "share" << std::endl;
+  for (std::map<uint32_t, std::map<uint32_t, uint64_t> >::const_iterator link = perLink.begin (); link != perLink.end (); ++link)
+    {
+      uint64_t linkFrames = 0;
+      for (std::map<uint32_t, uint64_t>::const_iterator rate = link->second.begin (); rate != link->second.end (); ++rate)
+        {
+          linkFrames += rate->second;
+        }
+      for (std::map<uint32_t, uint64_t>::const_iterator rate = link->second.begin (); rate != link->second.end (); ++rate)
+        {
+          std::cout << std::setw (8) << link->first << std::setw (12) << std::fixed << std::setprecision (1) << rate->first / 1000.0
+                    << std::setw (12) << rate->second << std::setw (10) << std::setprecision (3)
+                    << (double)rate->second / linkFrames << std::endl;
+        }
+    }
+  for (std::map<uint32_t, uint64_t>::const_iterator rate = total.begin (); rate != total.end (); ++rate)
+    {
+      std::cout << std::setw (8) << "all" << std::setw (12) << std::fixed << std::setprecision (1) << rate->first / 1000.0
+                << std::setw (12) << rate->second << std::setw (10) << std::setprecision (3)
+                << (double)rate->second / frames << std::endl;
+    }
+}
+
+//Retry chains of data frames: a chain starts with a first attempt and takes every retry after it, it ends
+//delivered at the next first attempt of the same transmitter on the link, or given up at a FRAME_FINAL_FAILED.
+//A chain the trace ends in is counted as open.
+void
+PrintRetries (const TraceFile &trace, const Options &options)
+{
+  std::map<std::pair<uint32_t, uint32_t>, RetryChains> chains; //by (transmitter, link)
+  for (uint64_t i = 0; i < trace.GetN (); ++i)
+    {
+      const FrameRecord &record = trace.Get (i);
+      if (!Selected (options, record)
+          || !(IsDataTx (record) || record.kind == FRAME_FINAL_FAILED || record.kind == FRAME_RTS_FAILED))
+        {
+          continue;
+        }
+      std::pair<uint32_t, uint32_t> key (record.node, record.link);
+      if (chains.find (key) == chains.end ())
+        {
+          RetryChains empty;
+          memset (&empty, 0, sizeof (empty));
+          chains[key] = empty;
+        }
+      RetryChains &chain = chains[key];
+      if (record.kind == FRAME_RTS_FAILED)
+        {
+          ++chain.rtsFailed;
+        }
+      else if (record.kind == FRAME_FINAL_FAILED)
+        {
+          ++chain.givenUp;
+          chain.attempts = 0;
+        }
+      else if (record.flags & FRAME_RETRY)
+        {
+          ++chain.attempts;
+        }
+      else
+        {
+          if (chain.attempts > 0)
+            {
+              ++chain.delivered[std::min (chain.attempts, maxAttempts) - 1];
+            }
+          chain.attempts = 1;
+        }
+    }
+  for (std::map<std::pair<uint32_t, uint32_t>, RetryChains>::iterator it = chains.begin (); it != chains.end (); ++it)
+    {
+      if (it->second.attempts > 0)
+        {
+          ++it->second.open;
+          it->second.attempts = 0;
+        }
+    }
+  std::cout << "retries" << std::endl;
+  std::cout << std::setw (8) << "node" << std::setw (8) << "link";
+  for (int a = 1; a <= maxAttempts; ++a)
+    {
+      std::ostringstream label;
+      label << (a < maxAttempts ? "" : ">=") << a;
+      std::cout << std::setw (10) << label.str ();
+    }
+  std::cout << std::setw (10) << "given up" << std::setw (10) << "open" << std::setw (10) << "mean" << std::setw (11) << "rts failed" << std::endl;
+  for (std::map<std::pair<uint32_t, uint32_t>, RetryChains>::const_iterator it = chains.begin (); it != chains.end (); ++it)
+    {
+      const RetryChains &chain = it->second;
+      uint64_t delivered = 0;
+      uint64_t attempts = 0;
+      std::cout << std::setw (8) << it->first.first << std::setw (8) << it->first.second;
+      for (int a = 0; a < maxAttempts; ++a)
+        {
+          std::cout << std::setw (10) << chain.delivered[a];
+          delivered += chain.delivered[a];
+          attempts += chain.delivered[a] * (a + 1);
+        }
+      std::cout << std::setw (10) << chain.givenUp << std::setw (10) << chain.open << std::setw (10) << std::fixed << std::setprecision (2)
+                << (delivered > 0 ? (double)attempts / delivered : 0.0) << std::setw (11) << chain.rtsFailed << std::endl;
+    }
+}
+
+//Per link and time bin: data frames sent, how many were retries, failed attempts, mean rate and the mean
+//SNR of the data frames received on the link
+void
+PrintTimeline (const TraceFile &trace, const Options &options)
+{
+  std::map<std::pair<uint32_t, int64_t>, TimelineBin> bins; //by (link, bin)
+  for (uint64_t i = 0; i < trace.GetN (); ++i)
+    {
+      const FrameRecord &record = trace.Get (i);
+      bool received = record.kind == FRAME_RX && (record.flags & FRAME_DATA) && record.snrDb == record.snrDb;
+      bool failed = record.kind == FRAME_DATA_FAILED || record.kind == FRAME_FINAL_FAILED;
+      if (!Selected (options, record) || !(IsDataTx (record) || received || failed))
+        {
+          continue;
+        }
+      std::pair<uint32_t, int64_t> key (record.link, (int64_t)std::floor (record.time / options.bin));
+      if (bins.find (key) == bins.end ())
+        {
+          TimelineBin empty;
+          memset (&empty, 0, sizeof (empty));
+          bins[key] = empty;
+        }
+      TimelineBin &bin = bins[key];
+      if (IsDataTx (record))
+        {
+          ++bin.frames;
+          bin.retries += (record.flags & FRAME_RETRY) ? 1 : 0;
+          bin.rateSum += record.rateKbps / 1000.0;
+        }
+      else if (received)
+        {
+          bin.snrSum += record.snrDb;
+          ++bin.snrs;
+        }
+      else
+        {
+          ++bin.failed;
+        }
+    }
+  std::cout << "timeline" << std::endl;
+  std::cout << std::setw (8) << "link" << std::setw (10) << "time s" << std::setw (10) << "frames" << std::setw (10) << "retries"
+            << std::setw (10) << "failed" << std::setw (12) << "rate Mbps" << std::setw (10) << "snr dB" << std::endl;
+  for (std::map<std::pair<uint32_t, int64_t>, TimelineBin>::const_iterator it = bins.begin (); it != bins.end (); ++it)
+    {
+      const TimelineBin &bin = it->second;
+      std::cout << std::setw (8) << it->first.first << std::setw (10) << std::fixed << std::setprecision (2)
+                << it->first.second * options.bin << std::setw (10) << bin.frames << std::setw (10) << bin.retries
+                << std::setw (10) << bin.failed << std::setw (12) << (bin.frames > 0 ? bin.rateSum / bin.frames : 0.0)
+                << std::setw (10) << std::setprecision (1) << (bin.snrs > 0 ? bin.snrSum / bin.snrs : std::numeric_limits<double>::quiet_NaN ()) << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  Options options;
+  options.station = -1;
+  options.bin = 1.0;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string argument = argv[i];
+      if (argument.compare (0, 10, "--station=") == 0)
+        {
+          options.station = atol (argument.c_str () + 10);
+        }
+      else if (argument.compare (0, 6, "--bin=") == 0)
+        {
+          options.bin = atof (argument.c_str () + 6);
+        }
+      else if (argument.compare (0, 7, "--only=") == 0)
+        {
+          options.only = argument.substr (7);
+        }
+      else if (argument.compare (0, 2, "--") == 0)
+        {
+          std::cerr << "unknown option " << argument << std::endl;
+          return 2;
+        }
+      else
+        {
+          files.push_back (argument);
+        }
+    }
+  if (files.empty () || options.bin <= 0.0
+      || !(options.only.empty () || options.only == "rates" || options.only == "retries" || options.only == "timeline"))
+    {
+      std::cerr << "usage: " << argv[0] << " [--station=<node>] [--bin=<seconds>] [--only=rates|retries|timeline] <file.trc>..."
+                << std::endl;
+      return 2;
+    }
+
+  int status = 0;
+  for (size_t f = 0; f < files.size (); ++f)
+    {
+      TraceFile trace (files[f]);
+      if (!trace.GetError ().empty ())
+        {
+          std::cerr << files[f] << ": " << trace.GetError () << std::endl;
+          status = 1;
+          continue;
+        }
+      std::cout << "# " << files[f] << ": " << std::string (trace.GetHeader ()->run, strnlen (trace.GetHeader ()->run, sizeof (trace.GetHeader ()->run)))
+                << ", " << trace.GetN () << " records" << std::endl;
+      if (options.only.empty () || options.only == "rates")
+        {
+          PrintRates (trace, options);
+        }
+      if (options.only.empty () || options.only == "retries")
+        {
+          PrintRetries (trace, options);
+        }
+      if (options.only.empty () || options.only == "timeline")
+        {
+          PrintTimeline (trace, options);
+        }
+    }
+  return status;
+}